@@ -0,0 +1,96 @@
+// a producer handing values to a consumer through one slot: Option<T> behind a std::mutex against AtomicOption<T>,
+// for a pointer (niche) and a uint64_t (tag word, double-width CAS)
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "../src/atomic_option.hpp"
+
+using navp::AtomicOption;
+using navp::None;
+using navp::Option;
+
+// keeps the compiler from dropping the sums
+static volatile std::uint64_t g_sink;
+
+template <typename T>
+class mutex_slot {
+ public:
+  bool put(const T& val) {
+    std::lock_guard lock(_m_mutex);
+    if (_m_val.is_some()) {
+      return false;
+    }
+    _m_val = val;
+    return true;
+  }
+  Option<T> take() {
+    std::lock_guard lock(_m_mutex);
+    return std::exchange(_m_val, None);
+  }
+
+ private:
+  std::mutex _m_mutex;
+  Option<T> _m_val;
+};
+
+template <typename T>
+class atomic_slot {
+ public:
+  bool put(const T& val) { return _m_val.put(val, std::memory_order_release); }
+  Option<T> take() { return _m_val.take(std::memory_order_acquire); }
+
+ private:
+  AtomicOption<T> _m_val;
+};
+
+static char g_buffer[256];
+
+static char* make_value(std::uint64_t i, char*) { return &g_buffer[i & 0xFF]; }
+static std::uint64_t make_value(std::uint64_t i, std::uint64_t) { return i; }
+static std::uint64_t as_u64(char* p) { return static_cast<std::uint64_t>(p - g_buffer); }
+static std::uint64_t as_u64(std::uint64_t v) { return v; }
+
+template <typename T, template <typename> class Slot>
+static double ns_per_handoff(std::uint64_t n) {
+  double best = 1e300;
+  for (int rep = 0; rep < 3; ++rep) {
+    Slot<T> slot;
+    std::uint64_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+      for (std::uint64_t received = 0; received < n;) {
+        if (auto v = slot.take()) {
+          sum += as_u64(v.unwrap_unchecked());
+          ++received;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+    for (std::uint64_t i = 1; i <= n; ++i) {
+      while (!slot.put(make_value(i, T{}))) {
+        std::this_thread::yield();
+      }
+    }
+    consumer.join();
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    g_sink = sum;
+    best = std::min(best, took.count() / static_cast<double>(n));
+  }
+  return best;
+}
+
+int main() {
+  constexpr std::uint64_t n = 1000000;
+  std::printf("AtomicOption<char*> lock-free: %d, AtomicOption<std::uint64_t> lock-free: %d\n",
+              AtomicOption<char*>().is_lock_free(), AtomicOption<std::uint64_t>().is_lock_free());
+  std::printf("char*:         mutex %7.2f ns, atomic %7.2f ns per hand-off\n", ns_per_handoff<char*, mutex_slot>(n),
+              ns_per_handoff<char*, atomic_slot>(n));
+  std::printf("std::uint64_t: mutex %7.2f ns, atomic %7.2f ns per hand-off\n",
+              ns_per_handoff<std::uint64_t, mutex_slot>(n), ns_per_handoff<std::uint64_t, atomic_slot>(n));
+}
@@ -0,0 +1,103 @@
+// Result<int, BigError> against Result<int, Boxed<BigError>> over a range of error rates: returned through three call
+// levels, and stored in a std::vector then summed
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../src/boxed.hpp"
+#include "../src/result.hpp"
+
+using navp::Boxed;
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+
+struct BigError {
+  int code;
+  std::array<char, 120> detail;
+};
+
+// keeps the compiler from folding the inputs
+static volatile long g_sink;
+
+template <typename E>
+[[gnu::noinline]] static Result<int, E> leaf(int x) {
+  if (x < 0) {
+    return Err(BigError{x, {}});
+  }
+  return Ok(x * 3 + 1);
+}
+
+template <typename E>
+[[gnu::noinline]] static Result<int, E> mid(int x) {
+  auto r = leaf<E>(x);
+  if (r.is_err()) {
+    return Err(std::move(r).unwrap_err_unchecked());
+  }
+  return Ok(r.unwrap_unchecked() + 2);
+}
+
+template <typename E>
+[[gnu::noinline]] static Result<int, E> top(int x) {
+  auto r = mid<E>(x);
+  if (r.is_err()) {
+    return Err(std::move(r).unwrap_err_unchecked());
+  }
+  return Ok(r.unwrap_unchecked() * 2);
+}
+
+template <typename E>
+static double ns_per_call(const std::vector<int>& inputs) {
+  double best = 1e300;
+  for (int rep = 0; rep < 5; ++rep) {
+    long acc = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int x : inputs) {
+      auto r = top<E>(x);
+      acc += r.is_ok() ? r.unwrap_unchecked() : 1;
+    }
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    g_sink = acc;
+    best = std::min(best, took.count() / static_cast<double>(inputs.size()));
+  }
+  return best;
+}
+
+// results kept in a vector, where the size of the Result is memory traffic
+template <typename E>
+static double ns_per_stored(const std::vector<int>& inputs) {
+  double best = 1e300;
+  for (int rep = 0; rep < 5; ++rep) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Result<int, E>> results;
+    results.reserve(inputs.size());
+    for (int x : inputs) {
+      results.push_back(leaf<E>(x));
+    }
+    long acc = 0;
+    for (const auto& r : results) {
+      acc += r.is_ok() ? r.unwrap_unchecked() : 1;
+    }
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    g_sink = acc;
+    best = std::min(best, took.count() / static_cast<double>(inputs.size()));
+  }
+  return best;
+}
+
+int main() {
+  std::printf("sizeof(Result<int, BigError>) = %zu, sizeof(Result<int, Boxed<BigError>>) = %zu\n",
+              sizeof(Result<int, BigError>), sizeof(Result<int, Boxed<BigError>>));
+  constexpr std::size_t n = 1000000;
+  for (double rate : {0.0, 0.001, 0.01, 0.1, 0.5}) {
+    std::vector<int> inputs(n);
+    const auto every = rate > 0 ? static_cast<std::size_t>(1 / rate) : n + 1;
+    for (std::size_t i = 0; i < n; ++i) {
+      inputs[i] = i % every == every - 1 ? -static_cast<int>(i) - 1 : static_cast<int>(i);
+    }
+    std::printf("error rate %5.1f%%: call inline %6.2f ns, boxed %6.2f ns | stored inline %6.2f ns, boxed %6.2f ns\n",
+                rate * 100, ns_per_call<BigError>(inputs), ns_per_call<Boxed<BigError>>(inputs),
+                ns_per_stored<BigError>(inputs), ns_per_stored<Boxed<BigError>>(inputs));
+  }
+}
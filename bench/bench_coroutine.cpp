@@ -0,0 +1,95 @@
+// Error propagation through three call levels: hand-written checks, NAVP_TRY, co_await, and exceptions
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/coroutine.hpp"
+#include "../src/try.hpp"
+
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+
+using result_t = Result<long, int>;
+
+// keeps the compiler from folding the inputs
+static volatile long g_sink;
+
+[[gnu::noinline]] static result_t leaf(long x) {
+  if (x < 0) {
+    return Err(static_cast<int>(x));
+  }
+  return Ok(x * 3 + 1);
+}
+
+// hand-written propagation
+[[gnu::noinline]] static result_t mid_manual(long x) {
+  auto r = leaf(x);
+  if (r.is_err()) {
+    return Err(r.unwrap_err());
+  }
+  return Ok(r.unwrap() + 2);
+}
+[[gnu::noinline]] static result_t top_manual(long x) {
+  auto r = mid_manual(x);
+  if (r.is_err()) {
+    return Err(r.unwrap_err());
+  }
+  return Ok(r.unwrap() * 2);
+}
+
+// NAVP_TRY
+[[gnu::noinline]] static result_t mid_try(long x) { return Ok(NAVP_TRY(leaf(x)) + 2); }
+[[gnu::noinline]] static result_t top_try(long x) { return Ok(NAVP_TRY(mid_try(x)) * 2); }
+
+// co_await
+[[gnu::noinline]] static result_t mid_coro(long x) { co_return co_await leaf(x) + 2; }
+[[gnu::noinline]] static result_t top_coro(long x) { co_return co_await mid_coro(x) * 2; }
+
+// exceptions
+[[gnu::noinline]] static long leaf_throw(long x) {
+  if (x < 0) {
+    throw std::invalid_argument("negative");
+  }
+  return x * 3 + 1;
+}
+[[gnu::noinline]] static long mid_throw(long x) { return leaf_throw(x) + 2; }
+[[gnu::noinline]] static result_t top_throw(long x) {
+  try {
+    return Ok(mid_throw(x) * 2);
+  } catch (const std::invalid_argument&) {
+    return Err(static_cast<int>(x));
+  }
+}
+
+template <typename F>
+static double ns_per_call(const std::vector<long>& inputs, F&& f) {
+  double best = 1e300;
+  for (int rep = 0; rep < 5; ++rep) {
+    long acc = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (long x : inputs) {
+      auto r = f(x);
+      acc += r.is_ok() ? r.unwrap_unchecked() : 1;
+    }
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    g_sink = acc;
+    best = std::min(best, took.count() / static_cast<double>(inputs.size()));
+  }
+  return best;
+}
+
+int main() {
+  constexpr std::size_t n = 1000000;
+  for (double rate : {0.0, 0.01, 0.1, 0.5}) {
+    std::vector<long> inputs(n);
+    const auto every = rate > 0 ? static_cast<std::size_t>(1 / rate) : n + 1;
+    for (std::size_t i = 0; i < n; ++i) {
+      inputs[i] = i % every == every - 1 ? -static_cast<long>(i) : static_cast<long>(i);
+    }
+    std::printf("error rate %4.0f%%: manual %6.2f ns, NAVP_TRY %6.2f ns, co_await %6.2f ns, exceptions %8.2f ns\n",
+                rate * 100, ns_per_call(inputs, top_manual), ns_per_call(inputs, top_try), ns_per_call(inputs, top_coro),
+                ns_per_call(inputs, top_throw));
+  }
+}
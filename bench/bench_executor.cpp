@@ -0,0 +1,69 @@
+// TaskExecutor against one std::async per task, validating independent records
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../src/executor.hpp"
+
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+
+using result_t = Result<double, std::string>;
+
+// a record check of a few microseconds, 1 record in 100 fails
+static result_t validate(std::size_t i) {
+  double acc = static_cast<double>(i);
+  for (int k = 0; k < 2000; ++k) {
+    acc = acc * 1.0000001 + 0.5;
+  }
+  if (i % 100 == 0) {
+    return Err("record " + std::to_string(i) + " rejected");
+  }
+  return Ok(acc);
+}
+
+template <typename F>
+static double best_ms(int reps, F&& f) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - start;
+    best = std::min(best, took.count());
+  }
+  return best;
+}
+
+int main() {
+  for (std::size_t n : {1000, 10000, 100000}) {
+    std::size_t errs_exec = 0, errs_async = 0;
+    const double exec_ms = best_ms(5, [&] {
+      auto out = navp::TaskExecutor().run_indexed(n, validate);
+      errs_exec = out.count_err();
+    });
+    double async_ms = 0;
+    try {
+      async_ms = best_ms(5, [&] {
+        std::vector<std::future<result_t>> futures;
+        futures.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+          futures.push_back(std::async(std::launch::async, validate, i));
+        }
+        errs_async = 0;
+        for (auto& fut : futures) {
+          errs_async += fut.get().is_err();
+        }
+      });
+    } catch (const std::system_error& e) {
+      // one thread per task runs into the thread limit
+      std::printf("%7zu tasks: TaskExecutor %9.3f ms, std::async failed: %s\n", n, exec_ms, e.what());
+      continue;
+    }
+    std::printf("%7zu tasks: TaskExecutor %9.3f ms, std::async %9.3f ms (%zu/%zu errors)\n", n, exec_ms, async_ms,
+                errs_exec, errs_async);
+  }
+}
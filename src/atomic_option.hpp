@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "option.hpp"
+
+// AtomicOption<T>: an Option<T> slot in a single atomic word, for handing values between threads without a mutex.
+//
+//   AtomicOption<Job*> slot;
+//   producer: while (!slot.put(job)) { ... }     // fills the slot only when it is empty
+//   consumer: if (auto job = slot.take()) { ... } // empties the slot
+//
+// T must be trivially copyable, 1, 2, 4, 8 or 16 bytes, and without padding bits. When T has a niche (pointers,
+// niche_traits specializations) None is niche_traits<T>::none() and the word is as wide as T. Otherwise a tag bit
+// next to the value marks Some and the word is twice as wide as T, so up to 8-byte values without a niche fit.
+// 16-byte words use the double-width CAS of the target (cmpxchg16b, casp) where it has one. GCC reaches it through
+// libatomic, so link with -latomic; GCC's is_lock_free() answers false for 16 bytes even when libatomic uses the CAS.
+//
+// Like std::atomic, compare_exchange() compares object representations, so the values of T are compared bitwise.
+
+namespace navp {
+
+namespace details {
+
+struct alignas(16) atomic_option_wide {
+  std::uint64_t lo;
+  std::uint64_t hi;
+};
+
+template <std::size_t Size>
+struct atomic_option_uint {};
+template <>
+struct atomic_option_uint<1> {
+  using type = std::uint8_t;
+};
+template <>
+struct atomic_option_uint<2> {
+  using type = std::uint16_t;
+};
+template <>
+struct atomic_option_uint<4> {
+  using type = std::uint32_t;
+};
+template <>
+struct atomic_option_uint<8> {
+  using type = std::uint64_t;
+};
+template <>
+struct atomic_option_uint<16> {
+  using type = atomic_option_wide;
+};
+
+template <typename T>
+concept atomic_option_value =
+    std::is_trivially_copyable_v<T> &&
+    (std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>) &&
+    (has_niche<T> ? (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16)
+                  : (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8));
+
+// Option<T> <-> word, None always maps to the same word so that compare_exchange can compare words
+template <typename T>
+struct atomic_option_codec;
+
+// None is the niche, the word is the bits of T
+template <typename T>
+  requires has_niche<T>
+struct atomic_option_codec<T> {
+  using word = typename atomic_option_uint<sizeof(T)>::type;
+
+  static constexpr word encode(const Option<T>& opt) noexcept {
+    return std::bit_cast<word>(opt.is_some() ? opt.unwrap_unchecked() : niche_traits<T>::none());
+  }
+  static constexpr Option<T> decode(word w) noexcept {
+    const T val = std::bit_cast<T>(w);
+    return niche_traits<T>::is_none(val) ? Option<T>() : Option<T>(val);
+  }
+};
+
+// the value in the low half and the tag bit above it, None is all zero
+template <typename T>
+  requires(!has_niche<T> && sizeof(T) < 8)
+struct atomic_option_codec<T> {
+  using bits = typename atomic_option_uint<sizeof(T)>::type;
+  using word = typename atomic_option_uint<2 * sizeof(T)>::type;
+  static constexpr word some_bit = word(1) << (8 * sizeof(T));
+
+  static constexpr word encode(const Option<T>& opt) noexcept {
+    return opt.is_some() ? word(some_bit | std::bit_cast<bits>(opt.unwrap_unchecked())) : word(0);
+  }
+  static constexpr Option<T> decode(word w) noexcept {
+    return (w & some_bit) != 0 ? Option<T>(std::bit_cast<T>(static_cast<bits>(w))) : Option<T>();
+  }
+};
+
+template <typename T>
+  requires(!has_niche<T> && sizeof(T) == 8)
+struct atomic_option_codec<T> {
+  using word = atomic_option_wide;
+
+  static constexpr word encode(const Option<T>& opt) noexcept {
+    return opt.is_some() ? word{std::bit_cast<std::uint64_t>(opt.unwrap_unchecked()), 1} : word{0, 0};
+  }
+  static constexpr Option<T> decode(word w) noexcept {
+    return w.hi != 0 ? Option<T>(std::bit_cast<T>(w.lo)) : Option<T>();
+  }
+};
+
+}  // namespace details
+
+template <typename T>
+class AtomicOption {
+  static_assert(details::atomic_option_value<T>,
+                "AtomicOption<T> needs a trivially copyable T of 1, 2, 4 or 8 bytes (16 with a niche) without padding");
+
+  using codec = details::atomic_option_codec<T>;
+  using word = typename codec::word;
+
+ public:
+  using value_type = T;
+
+  static constexpr bool is_always_lock_free = std::atomic<word>::is_always_lock_free;
+
+  constexpr AtomicOption() noexcept : _m_word(codec::encode(None)) {}
+  AtomicOption(const Option<T>& init) noexcept : _m_word(codec::encode(init)) {}
+  AtomicOption(const AtomicOption&) = delete;
+  AtomicOption& operator=(const AtomicOption&) = delete;
+
+  bool is_lock_free() const noexcept { return _m_word.is_lock_free(); }
+
+  Option<T> load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return codec::decode(_m_word.load(order));
+  }
+  void store(const Option<T>& desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    _m_word.store(codec::encode(desired), order);
+  }
+
+  // store `desired` and return the previous content
+  Option<T> swap(const Option<T>& desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return codec::decode(_m_word.exchange(codec::encode(desired), order));
+  }
+
+  // empty the slot and return what it held
+  Option<T> take(std::memory_order order = std::memory_order_seq_cst) noexcept { return swap(None, order); }
+
+  // store Some(val) if the slot is empty, false when it is already full
+  // Also false for the niche value of T (e.g. nullptr), which would read back as None: the slot stays empty and the
+  // value is not handed off.
+  bool put(const T& val, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    Option<T> desired(val);
+    if (desired.is_none()) [[unlikely]] {
+      return false;
+    }
+    Option<T> expected;
+    return compare_exchange(expected, desired, order, std::memory_order_relaxed);
+  }
+
+  // store `desired` if the slot holds `expected`, otherwise load the current content into `expected`
+  bool compare_exchange(Option<T>& expected, const Option<T>& desired,
+                        std::memory_order success = std::memory_order_seq_cst,
+                        std::memory_order failure = std::memory_order_seq_cst) noexcept {
+    word w = codec::encode(expected);
+    if (_m_word.compare_exchange_strong(w, codec::encode(desired), success, failure)) {
+      return true;
+    }
+    expected = codec::decode(w);
+    return false;
+  }
+
+ private:
+  std::atomic<word> _m_word;
+};
+
+}  // namespace navp
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Boxed<E>: an error kept behind one pointer, for Result<T, Boxed<E>> when E is large and errors are rare.
+// sizeof(Result<int, Boxed<BigError>>) is 16 instead of sizeof(BigError) + 8, so returning and passing the Ok
+// Results stays cheap, and only an Err pays for an allocation and an indirection.
+//
+//   Result<int, Boxed<BigError>> r = Err(BigError{...});  // E converts implicitly
+//   r.unwrap_err()->line;
+//
+// The boxes come from a small per-thread free list for each box size, so an error that is created and dropped on
+// the same thread does not reach the global allocator. thin_error_t<E> picks Boxed<E> only when E is larger than two
+// pointers.
+
+namespace navp {
+
+namespace details {
+
+// per-thread free list of blocks of one size and alignment
+template <std::size_t Size, std::size_t Align>
+class box_pool {
+ public:
+  // blocks kept per thread and size class, the rest go back to the global allocator
+  static constexpr std::size_t max_free = 64;
+
+  static void* allocate() {
+    auto& s = _s_state;
+    if (s.head != nullptr) {
+      auto* block = s.head;
+      s.head = block->next;
+      --s.count;
+      return block;
+    }
+    return ::operator new(Size, std::align_val_t{Align});
+  }
+
+  static void deallocate(void* p) noexcept {
+    auto& s = _s_state;
+    if (s.closed || s.count == max_free) {
+      ::operator delete(p, Size, std::align_val_t{Align});
+      return;
+    }
+    // first push on this thread: instantiate the guard that empties the list at thread exit
+    _s_guard.arm();
+    s.head = ::new (p) block{s.head};
+    ++s.count;
+  }
+
+ private:
+  struct block {
+    block* next;
+  };
+
+  // trivially destructible, stays usable after the guard below is gone
+  struct state {
+    block* head = nullptr;
+    std::size_t count = 0;
+    bool closed = false;
+  };
+
+  struct exit_guard {
+    void arm() const noexcept {}
+    ~exit_guard() {
+      auto& s = _s_state;
+      s.closed = true;
+      while (s.head != nullptr) {
+        ::operator delete(std::exchange(s.head, s.head->next), Size, std::align_val_t{Align});
+      }
+      s.count = 0;
+    }
+  };
+
+  static inline thread_local constinit state _s_state{};
+  static inline thread_local exit_guard _s_guard;
+};
+
+}  // namespace details
+
+template <typename E>
+class Boxed {
+  static_assert(std::is_object_v<E> && !std::is_array_v<E> && !std::is_const_v<E>, "Boxed<E> needs a plain object type");
+
+ public:
+  using element_type = E;
+
+  Boxed(const E& err)
+    requires std::is_copy_constructible_v<E>
+      : _m_ptr(_s_make(err)) {}
+  Boxed(E&& err)
+    requires std::is_move_constructible_v<E>
+      : _m_ptr(_s_make(std::move(err))) {}
+  template <typename... Args>
+    requires std::is_constructible_v<E, Args...>
+  explicit Boxed(std::in_place_t, Args&&... args) : _m_ptr(_s_make(std::forward<Args>(args)...)) {}
+
+  Boxed(const Boxed& other)
+    requires std::is_copy_constructible_v<E>
+      : _m_ptr(_s_make(*other._m_ptr)) {}
+  // leaves `other` empty, it may only be destroyed, assigned to or compared
+  Boxed(Boxed&& other) noexcept : _m_ptr(std::exchange(other._m_ptr, nullptr)) {}
+
+  Boxed& operator=(const Boxed& other)
+    requires std::is_copy_constructible_v<E>
+  {
+    if (this != &other) {
+      Boxed tmp(other);
+      std::swap(_m_ptr, tmp._m_ptr);
+    }
+    return *this;
+  }
+  Boxed& operator=(Boxed&& other) noexcept {
+    if (this != &other) {
+      _s_free(std::exchange(_m_ptr, std::exchange(other._m_ptr, nullptr)));
+    }
+    return *this;
+  }
+
+  ~Boxed() { _s_free(_m_ptr); }
+
+  E& operator*() noexcept { return *_m_ptr; }
+  const E& operator*() const noexcept { return *_m_ptr; }
+  E* operator->() noexcept { return _m_ptr; }
+  const E* operator->() const noexcept { return _m_ptr; }
+  E* get() noexcept { return _m_ptr; }
+  const E* get() const noexcept { return _m_ptr; }
+
+  // compares the errors, not the boxes; an empty (moved-from) box only equals another empty one
+  friend bool operator==(const Boxed& a, const Boxed& b)
+    requires std::equality_comparable<E>
+  {
+    if (a._m_ptr == nullptr || b._m_ptr == nullptr) [[unlikely]] {
+      return a._m_ptr == b._m_ptr;
+    }
+    return *a._m_ptr == *b._m_ptr;
+  }
+
+ private:
+  using pool = details::box_pool<std::max(sizeof(E), sizeof(void*)), std::max(alignof(E), alignof(void*))>;
+
+  template <typename... Args>
+  static E* _s_make(Args&&... args) {
+    void* p = pool::allocate();
+#if defined(__cpp_exceptions)
+    try {
+      return ::new (p) E(std::forward<Args>(args)...);
+    } catch (...) {
+      pool::deallocate(p);
+      throw;
+    }
+#else
+    return ::new (p) E(std::forward<Args>(args)...);
+#endif
+  }
+
+  static void _s_free(E* p) noexcept {
+    if (p != nullptr) {
+      std::destroy_at(p);
+      pool::deallocate(p);
+    }
+  }
+
+  E* _m_ptr;
+};
+
+// E itself when it is at most `Threshold` bytes, Boxed<E> otherwise
+template <typename E, std::size_t Threshold = 2 * sizeof(void*)>
+using thin_error_t = std::conditional_t<(sizeof(E) > Threshold), Boxed<E>, E>;
+
+}  // namespace navp
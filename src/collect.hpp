@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "template_utils.hpp"
+
+// Turn ranges of Result/Option into a Result/Option of a container, and swap Option and Result nesting.
+//
+// Elements are moved out when the range owns them (an rvalue container) or yields rvalues, and copied otherwise.
+// Output vectors are reserved up front when the size is known.
+
+namespace navp {
+
+namespace details {
+
+// whether elements of R may be moved from when R is passed as R&&
+template <typename R>
+inline constexpr bool movable_elements_v =
+    !std::is_lvalue_reference_v<std::ranges::range_reference_t<R>> ||
+    (!std::is_lvalue_reference_v<R> && !std::ranges::view<std::remove_cvref_t<R>>);
+
+// the element as an rvalue when it may be moved from
+template <typename R, typename Elem>
+constexpr decltype(auto) forward_elem(Elem& elem) noexcept {
+  if constexpr (movable_elements_v<R>) {
+    return std::move(elem);
+  } else {
+    return static_cast<const Elem&>(elem);
+  }
+}
+
+template <typename R>
+constexpr void reserve_for(auto& vec, R& range) {
+  if constexpr (std::ranges::sized_range<R>) {
+    vec.reserve(static_cast<std::size_t>(std::ranges::size(range)));
+  }
+}
+
+}  // namespace details
+
+// collect(range of Result<T, E>) -> Result<std::vector<T>, E>
+// Stops at the first Err and returns it.
+template <std::ranges::input_range R>
+  requires details::range_of<R, Result>
+constexpr auto collect(R&& range) {
+  using result_t = details::range_elem_t<R>;
+  using T = typename result_t::ok_type;
+  using E = typename result_t::err_type;
+  using out_t = Result<std::vector<T>, E>;
+
+  std::vector<T> values;
+  details::reserve_for(values, range);
+  for (auto&& elem : range) {
+    if (elem.is_err()) {
+      return out_t(Err<E>(details::forward_elem<R>(elem).unwrap_err_unchecked()));
+    }
+    values.push_back(details::forward_elem<R>(elem).unwrap_unchecked());
+  }
+  return out_t(Ok<std::vector<T>>(std::move(values)));
+}
+
+// collect(range of Option<T>) -> Option<std::vector<T>>
+// None as soon as one element is None.
+template <std::ranges::input_range R>
+  requires details::range_of<R, Option>
+constexpr auto collect(R&& range) {
+  using T = typename details::range_elem_t<R>::value_type;
+
+  std::vector<T> values;
+  details::reserve_for(values, range);
+  for (auto&& elem : range) {
+    if (elem.is_none()) {
+      return Option<std::vector<T>>(None);
+    }
+    values.push_back(details::forward_elem<R>(elem).unwrap_unchecked());
+  }
+  return Some(std::move(values));
+}
+
+// partition_results(range of Result<T, E>) -> {oks, errs}
+// A sized forward range of lvalues is scanned once first so both vectors are reserved to their exact size. Other
+// sized ranges, such as a transform view, are read once, their elements may be expensive or side-effecting to
+// produce; there the oks are reserved to the whole size, errors being the rare case.
+template <std::ranges::input_range R>
+  requires details::range_of<R, Result>
+constexpr auto partition_results(R&& range) {
+  using result_t = details::range_elem_t<R>;
+  using T = typename result_t::ok_type;
+  using E = typename result_t::err_type;
+
+  std::pair<std::vector<T>, std::vector<E>> out;
+  if constexpr (std::ranges::forward_range<R> && std::ranges::sized_range<R> &&
+                std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>) {
+    std::size_t oks = 0;
+    for (const auto& elem : range) {
+      oks += elem.is_ok();
+    }
+    out.first.reserve(oks);
+    out.second.reserve(static_cast<std::size_t>(std::ranges::size(range)) - oks);
+  } else {
+    details::reserve_for(out.first, range);
+  }
+  for (auto&& elem : range) {
+    if (elem.is_ok()) {
+      out.first.push_back(details::forward_elem<R>(elem).unwrap_unchecked());
+    } else {
+      out.second.push_back(details::forward_elem<R>(elem).unwrap_err_unchecked());
+    }
+  }
+  return out;
+}
+
+// partition_options(range of Option<T>) -> {somes, indices of the Nones}
+template <std::ranges::input_range R>
+  requires details::range_of<R, Option>
+constexpr auto partition_options(R&& range) {
+  using T = typename details::range_elem_t<R>::value_type;
+
+  std::pair<std::vector<T>, std::vector<std::size_t>> out;
+  details::reserve_for(out.first, range);
+  std::size_t i = 0;
+  for (auto&& elem : range) {
+    if (elem.is_some()) {
+      out.first.push_back(details::forward_elem<R>(elem).unwrap_unchecked());
+    } else {
+      out.second.push_back(i);
+    }
+    ++i;
+  }
+  return out;
+}
+
+// transpose: Option<Result<T, E>> -> Result<Option<T>, E>
+// None maps to Ok(None), Some(Ok(x)) to Ok(Some(x)) and Some(Err(e)) to Err(e).
+template <typename T, typename E>
+constexpr Result<Option<T>, E> transpose(Option<Result<T, E>> op) {
+  if (op.is_none()) {
+    return Ok<Option<T>>(Option<T>(None));
+  }
+  auto&& r = std::move(op).unwrap_unchecked();
+  if (r.is_ok()) {
+    return Ok<Option<T>>(Some(std::move(r).unwrap_unchecked()));
+  }
+  return Err<E>(std::move(r).unwrap_err_unchecked());
+}
+
+// transpose: Result<Option<T>, E> -> Option<Result<T, E>>
+// Ok(None) maps to None, Ok(Some(x)) to Some(Ok(x)) and Err(e) to Some(Err(e)).
+template <typename T, typename E>
+constexpr Option<Result<T, E>> transpose(Result<Option<T>, E> r) {
+  if (r.is_err()) {
+    return Some(Result<T, E>(Err<E>(std::move(r).unwrap_err_unchecked())));
+  }
+  auto&& op = std::move(r).unwrap_unchecked();
+  if (op.is_none()) {
+    return None;
+  }
+  return Some(Result<T, E>(Ok<T>(std::move(op).unwrap_unchecked())));
+}
+
+}  // namespace navp
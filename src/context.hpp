@@ -0,0 +1,478 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "result.hpp"
+
+// Context chains on errors, formatted only when displayed.
+//
+//   Result<Config, ContextError<ErrorCode>> load(int epoch) {
+//     auto text = read_file(path).context("while reading {}", path);   // Result<std::string, ContextError<...>>
+//     ...
+//     return parse(text).context("while parsing epoch {}", epoch);
+//   }
+//   load(3).unwrap_err().to_string() == "while parsing epoch 3: parse: not a number"
+//
+// `result.context(fmt, args...)` turns an Err(e) into Err(ContextError<E>) with one more context, an Ok passes
+// through untouched. The format string must be a literal with one `{}` per argument. The arguments are copied into
+// a context_arena (characters of string arguments included) and formatted with std::format when the error is
+// displayed, or with a built-in `{}` formatter for arithmetic types, strings and types with a to_string() member
+// where <format> is not available.
+//
+// Every context is a link in an immutable, reference-counted chain allocated from the arena installed on the
+// current thread, so copying a ContextError is one atomic increment and adding a context does not call malloc. A
+// context_arena object installs itself for the thread while it lives (e.g. one per request). Without one, each
+// thread has a default arena. An arena is rewound whenever none of its links is alive, and its memory is shared with
+// its links: an error may outlive the arena and the thread it was created on, the last of them frees the chunks.
+
+namespace navp {
+
+namespace details {
+
+// the chunks of a context_arena, referenced by the arena and by every link allocated from it, and freed with the
+// last of them on whichever thread that is
+class context_pool {
+ public:
+  explicit context_pool(std::size_t chunk_size) noexcept : _m_chunk_size(chunk_size) {}
+  context_pool(const context_pool&) = delete;
+  context_pool& operator=(const context_pool&) = delete;
+  ~context_pool() { _m_free_chunks(nullptr); }
+
+  // only called by the owning arena, on its thread
+  void* allocate(std::size_t n, std::size_t align) {
+    // only the arena's own reference left: no link is alive and none can appear concurrently
+    if (_m_refs.load(std::memory_order_acquire) == 1 && _m_first != nullptr) {
+      _m_rewind();
+    }
+    auto p = reinterpret_cast<std::uintptr_t>(_m_top);
+    auto aligned = (p + align - 1) & ~(std::uintptr_t{align} - 1);
+    if (_m_top == nullptr || aligned + n > reinterpret_cast<std::uintptr_t>(_m_end)) {
+      _m_grow(n + align);
+      p = reinterpret_cast<std::uintptr_t>(_m_top);
+      aligned = (p + align - 1) & ~(std::uintptr_t{align} - 1);
+    }
+    _m_top = reinterpret_cast<std::byte*>(aligned + n);
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  // references other than the arena's
+  std::size_t live() const noexcept { return _m_refs.load(std::memory_order_acquire) - 1; }
+
+  void retain() noexcept { _m_refs.fetch_add(1, std::memory_order_relaxed); }
+  // may be called from any thread
+  static void release(context_pool* pool) noexcept {
+    if (pool->_m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete pool;
+    }
+  }
+
+ private:
+  struct chunk {
+    chunk* next;
+    std::size_t size;
+    std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+  };
+
+  void _m_grow(std::size_t at_least) {
+    const auto size = std::max(_m_chunk_size, at_least);
+    auto* c = ::new (::operator new(sizeof(chunk) + size)) chunk{nullptr, size};
+    if (_m_last != nullptr) {
+      _m_last->next = c;
+    } else {
+      _m_first = c;
+    }
+    _m_last = c;
+    _m_top = c->data();
+    _m_end = c->data() + size;
+  }
+
+  // every link is gone: keep the first chunk, free the others
+  void _m_rewind() noexcept {
+    _m_free_chunks(_m_first);
+    _m_first->next = nullptr;
+    _m_last = _m_first;
+    _m_top = _m_first->data();
+    _m_end = _m_first->data() + _m_first->size;
+  }
+
+  // free the chunks after `keep`, all of them when it is nullptr
+  void _m_free_chunks(chunk* keep) noexcept {
+    for (auto* c = keep != nullptr ? keep->next : _m_first; c != nullptr;) {
+      ::operator delete(std::exchange(c, c->next));
+    }
+    if (keep == nullptr) {
+      _m_first = _m_last = nullptr;
+      _m_top = _m_end = nullptr;
+    }
+  }
+
+  std::size_t _m_chunk_size;
+  chunk* _m_first = nullptr;
+  chunk* _m_last = nullptr;
+  std::byte* _m_top = nullptr;
+  std::byte* _m_end = nullptr;
+  // the arena's reference plus one per live link
+  std::atomic<std::size_t> _m_refs{1};
+};
+
+}  // namespace details
+
+class context_arena {
+ public:
+  static constexpr std::size_t default_chunk_size = 4096;
+
+  explicit context_arena(std::size_t chunk_size = default_chunk_size)
+      : _m_pool(new details::context_pool(chunk_size)), _m_prev(_s_current) {
+    _s_current = this;
+  }
+  context_arena(const context_arena&) = delete;
+  context_arena& operator=(const context_arena&) = delete;
+  ~context_arena() {
+    if (_m_installed) {
+      _s_current = _m_prev;
+    }
+    // links still alive keep the chunks until the last of them is released
+    details::context_pool::release(_m_pool);
+  }
+
+  // the arena installed on this thread, or the thread's default one
+  static context_arena& current() {
+    if (_s_current != nullptr) {
+      return *_s_current;
+    }
+    static thread_local context_arena fallback(default_chunk_size, uninstalled_t{});
+    return fallback;
+  }
+
+  // links allocated from this arena and not yet destroyed
+  std::size_t live() const noexcept { return _m_pool->live(); }
+
+  details::context_pool& _m_get_pool() noexcept { return *_m_pool; }
+
+ private:
+  struct uninstalled_t {};
+
+  context_arena(std::size_t chunk_size, uninstalled_t)
+      : _m_pool(new details::context_pool(chunk_size)), _m_prev(nullptr), _m_installed(false) {}
+
+  details::context_pool* _m_pool;
+  context_arena* _m_prev;
+  bool _m_installed = true;
+  static inline thread_local context_arena* _s_current = nullptr;
+};
+
+namespace details {
+
+// a format string literal with one `{}` per argument, checked at compile time
+template <typename... Args>
+struct context_fmt {
+  template <std::size_t N>
+  consteval context_fmt(const char (&s)[N]) : str(s, N - 1) {
+    std::size_t placeholders = 0;
+    for (std::size_t i = 0; i < str.size(); ++i) {
+      if (str[i] == '{' && i + 1 < str.size() && str[i + 1] == '{') {
+        ++i;
+      } else if (str[i] == '}' && i + 1 < str.size() && str[i + 1] == '}') {
+        ++i;
+      } else if (str[i] == '{' && i + 1 < str.size() && str[i + 1] == '}') {
+        ++placeholders;
+        ++i;
+      } else if (str[i] == '{' || str[i] == '}') {
+        _s_fail("context format: only {} placeholders are supported");
+      }
+    }
+    if (placeholders != sizeof...(Args)) {
+      _s_fail("context format: the number of {} does not match the number of arguments");
+    }
+  }
+
+  std::string_view str;
+
+ private:
+  // not constexpr, calling it in the consteval constructor is the compile error
+  static void _s_fail(const char*) {}
+};
+
+template <typename T>
+concept has_to_string = requires(const T& val) {
+  { val.to_string() } -> std::convertible_to<std::string_view>;
+};
+
+// arguments are stored by value, string-like ones as a view of characters copied into the arena
+template <typename A>
+using context_capture_t =
+    std::conditional_t<std::is_convertible_v<const std::remove_cvref_t<A>&, std::string_view> &&
+                           !has_to_string<std::remove_cvref_t<A>>,
+                       std::string_view, std::remove_cvref_t<A>>;
+
+template <typename T>
+void append_context_arg(std::string& out, const T& val) {
+  if constexpr (std::is_same_v<T, bool>) {
+    out += val ? "true" : "false";
+  } else if constexpr (std::is_same_v<T, char>) {
+    out += val;
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    char buf[64];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), val);
+    out.append(buf, end);
+  } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+    out += std::string_view(val);
+  } else if constexpr (has_to_string<T>) {
+    out += val.to_string();
+  } else {
+    static_assert(sizeof(T) == 0, "context arguments must be arithmetic, strings or have a to_string() member");
+  }
+}
+
+// {{, }} and {} only, checked by context_fmt
+template <typename... Args>
+void format_context_builtin(std::string& out, std::string_view fmt, const Args&... args) {
+  const auto append_next = [&](std::size_t& i, const auto& arg) {
+    for (; i < fmt.size(); ++i) {
+      if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < fmt.size() && fmt[i + 1] == fmt[i]) {
+        out += fmt[i++];
+      } else if (fmt[i] == '{') {
+        i += 2;
+        append_context_arg(out, arg);
+        return;
+      } else {
+        out += fmt[i];
+      }
+    }
+  };
+  std::size_t i = 0;
+  (append_next(i, args), ...);
+  for (; i < fmt.size(); ++i) {
+    out += fmt[i];
+    if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < fmt.size() && fmt[i + 1] == fmt[i]) {
+      ++i;
+    }
+  }
+}
+
+template <typename... Args>
+void format_context(std::string& out, std::string_view fmt, const Args&... args) {
+#if defined(__cpp_lib_format_ranges)
+  if constexpr ((std::formattable<Args, char> && ...)) {
+    std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(args...));
+  } else {
+    format_context_builtin(out, fmt, args...);
+  }
+#else
+  format_context_builtin(out, fmt, args...);
+#endif
+}
+
+// one context of a chain, immutable once linked
+struct context_link {
+  context_link(context_link* below, context_pool* owner, void (*render_fn)(const context_link&, std::string&),
+               void (*destroy_fn)(context_link&) noexcept) noexcept
+      : next(below), pool(owner), render(render_fn), destroy(destroy_fn) {}
+
+  std::atomic<std::uint32_t> refs{1};
+  // the context below this one, owned
+  context_link* next;
+  // holds the memory of this link
+  context_pool* pool;
+  void (*render)(const context_link&, std::string&);
+  void (*destroy)(context_link&) noexcept;
+
+  static void retain(context_link* link) noexcept {
+    if (link != nullptr) {
+      link->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  static void release(context_link* link) noexcept {
+    while (link != nullptr && link->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      auto* next = link->next;
+      auto* pool = link->pool;
+      link->destroy(*link);
+      context_pool::release(pool);
+      link = next;
+    }
+  }
+};
+
+template <typename... Captured>
+struct context_node : context_link {
+  std::string_view fmt;
+  std::tuple<Captured...> args;
+
+  // the arguments are captured while the node is constructed, into memory of the same pool
+  template <typename... Args>
+  context_node(context_link* below, context_pool& owner, std::string_view format, Args&&... values)
+      : context_link(below, &owner, &_s_render, &_s_destroy),
+        fmt(format),
+        args(_s_capture<Captured>(owner, std::forward<Args>(values))...) {}
+
+  template <typename... Args>
+  static context_link* make(context_link* next, std::string_view fmt, Args&&... args) {
+    auto& owner = context_arena::current()._m_get_pool();
+    void* p = owner.allocate(sizeof(context_node), alignof(context_node));
+    // counted before the arguments are captured, so that capturing does not rewind the pool under the node
+    owner.retain();
+#if defined(__cpp_exceptions)
+    try {
+      return ::new (p) context_node(next, owner, fmt, std::forward<Args>(args)...);
+    } catch (...) {
+      context_pool::release(&owner);
+      throw;
+    }
+#else
+    return ::new (p) context_node(next, owner, fmt, std::forward<Args>(args)...);
+#endif
+  }
+
+ private:
+  template <typename C, typename A>
+  static C _s_capture(context_pool& owner, A&& arg) {
+    if constexpr (std::is_same_v<C, std::string_view>) {
+      const std::string_view view(arg);
+      auto* chars = static_cast<char*>(owner.allocate(view.size(), 1));
+      std::memcpy(chars, view.data(), view.size());
+      return std::string_view(chars, view.size());
+    } else {
+      return C(std::forward<A>(arg));
+    }
+  }
+
+  static void _s_render(const context_link& link, std::string& out) {
+    const auto& self = static_cast<const context_node&>(link);
+    std::apply([&](const auto&... args) { format_context(out, self.fmt, args...); }, self.args);
+  }
+
+  static void _s_destroy(context_link& link) noexcept { std::destroy_at(static_cast<context_node*>(&link)); }
+};
+
+}  // namespace details
+
+// An error with a chain of contexts, the most recent first.
+template <typename E>
+class ContextError {
+ public:
+  using error_type = E;
+
+  ContextError(const E& err) : _m_err(err) {}
+  ContextError(E&& err) noexcept(std::is_nothrow_move_constructible_v<E>) : _m_err(std::move(err)) {}
+
+  ContextError(const ContextError& other) : _m_err(other._m_err), _m_head(other._m_head) {
+    details::context_link::retain(_m_head);
+  }
+  ContextError(ContextError&& other) noexcept(std::is_nothrow_move_constructible_v<E>)
+      : _m_err(std::move(other._m_err)), _m_head(std::exchange(other._m_head, nullptr)) {}
+  ContextError& operator=(const ContextError& other) {
+    if (this != &other) {
+      _m_err = other._m_err;
+      details::context_link::retain(other._m_head);
+      details::context_link::release(std::exchange(_m_head, other._m_head));
+    }
+    return *this;
+  }
+  ContextError& operator=(ContextError&& other) noexcept(std::is_nothrow_move_assignable_v<E>) {
+    if (this != &other) {
+      _m_err = std::move(other._m_err);
+      details::context_link::release(std::exchange(_m_head, std::exchange(other._m_head, nullptr)));
+    }
+    return *this;
+  }
+  ~ContextError() { details::context_link::release(_m_head); }
+
+  // the original error
+  E& root() & noexcept { return _m_err; }
+  const E& root() const& noexcept { return _m_err; }
+  E&& root() && noexcept { return std::move(_m_err); }
+
+  // add a context on top
+  template <typename... Args>
+  ContextError& context(details::context_fmt<std::type_identity_t<Args>...> fmt, Args&&... args) & {
+    _m_head = details::context_node<details::context_capture_t<Args>...>::make(_m_head, fmt.str,
+                                                                                 std::forward<Args>(args)...);
+    return *this;
+  }
+  template <typename... Args>
+  ContextError&& context(details::context_fmt<std::type_identity_t<Args>...> fmt, Args&&... args) && {
+    return std::move(context(fmt, std::forward<Args>(args)...));
+  }
+
+  std::size_t depth() const noexcept {
+    std::size_t n = 0;
+    for (const auto* link = _m_head; link != nullptr; link = link->next) {
+      ++n;
+    }
+    return n;
+  }
+
+  // the formatted contexts, the most recent first
+  std::vector<std::string> contexts() const {
+    std::vector<std::string> out;
+    for (const auto* link = _m_head; link != nullptr; link = link->next) {
+      link->render(*link, out.emplace_back());
+    }
+    return out;
+  }
+
+  // "<context>: ... : <root>"
+  std::string to_string() const {
+    std::string out;
+    for (const auto* link = _m_head; link != nullptr; link = link->next) {
+      link->render(*link, out);
+      out += ": ";
+    }
+    details::append_context_arg(out, _m_err);
+    return out;
+  }
+
+ private:
+  E _m_err;
+  details::context_link* _m_head = nullptr;
+};
+
+namespace details {
+
+template <typename E>
+struct context_error {
+  using type = ContextError<E>;
+};
+template <typename E>
+struct context_error<ContextError<E>> {
+  using type = ContextError<E>;
+};
+
+}  // namespace details
+
+template <typename T, typename E>
+template <typename... Args>
+auto Result<T, E>::context(details::context_fmt<std::type_identity_t<Args>...> fmt, Args&&... args) && {
+  using error_t = typename details::context_error<E>::type;
+  using result_t = Result<T, error_t>;
+  if (is_ok()) [[likely]] {
+    if constexpr (std::is_void_v<T>) {
+      return result_t(Ok<void>());
+    } else {
+      return result_t(Ok<T>(std::move(*this)._m_get_ok_value()));
+    }
+  }
+  error_t err(std::move(*this)._m_get_err_value());
+  err.context(fmt, std::forward<Args>(args)...);
+  return result_t(Err<error_t>(std::move(err)));
+}
+
+}  // namespace navp
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <optional>
+#include <source_location>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "template_utils.hpp"
+
+// Coroutine support: a function returning Result<T, E> or Option<T> may co_await a Result or Option to unwrap it,
+// returning early with the Err/None when there is none.
+//
+//   Result<int, std::string> total(std::string_view a, std::string_view b) {
+//     int x = co_await parse(a);  // returns parse(a)'s Err from total() if there is one
+//     int y = co_await parse(b);
+//     co_return x + y;
+//   }
+//
+// These coroutines never suspend except to bail out, so they run to completion inside the call. Their frames are
+// therefore freed in LIFO order and come from a per-thread bump arena: a coroutine_arena object installs a caller
+// provided buffer for the current thread, otherwise a thread-local buffer of NAVP_COROUTINE_ARENA_SIZE bytes is
+// used. A frame that does not fit goes to ::operator new.
+//
+// The value returned from get_return_object() is converted to the Result/Option after the coroutine has finished
+// (GCC, Clang 16 and MSVC do this); the conversion panics if the compiler converts it eagerly.
+
+#ifndef NAVP_COROUTINE_ARENA_SIZE
+#define NAVP_COROUTINE_ARENA_SIZE 16384
+#endif
+
+namespace navp {
+
+// bump allocator for coroutine frames, installed for the current thread while it lives
+class coroutine_arena {
+ public:
+  // the buffer may be unaligned, frames start at its first __STDCPP_DEFAULT_NEW_ALIGNMENT__ boundary
+  explicit coroutine_arena(std::span<std::byte> buffer) noexcept
+      : _m_begin(_s_align_up(buffer.data(), buffer.data() + buffer.size())),
+        _m_top(_m_begin),
+        _m_end(buffer.data() + buffer.size()),
+        _m_prev(_s_current) {
+    _s_current = this;
+  }
+  coroutine_arena(const coroutine_arena&) = delete;
+  coroutine_arena& operator=(const coroutine_arena&) = delete;
+  ~coroutine_arena() { _s_current = _m_prev; }
+
+  // nullptr when the frame does not fit
+  void* allocate(std::size_t n) noexcept {
+    n = _s_round(n);
+    if (static_cast<std::size_t>(_m_end - _m_top) < n) {
+      return nullptr;
+    }
+    return std::exchange(_m_top, _m_top + n);
+  }
+
+  // false when p does not come from this arena
+  bool deallocate(void* p, std::size_t n) noexcept {
+    auto* bytes = static_cast<std::byte*>(p);
+    if (bytes < _m_begin || bytes >= _m_end) {
+      return false;
+    }
+    // Frames die in LIFO order. Only the top frame gives its bytes back: a frame freed out of order stays used until
+    // the arena is destroyed, and the default arena of a thread lives as long as the thread.
+    if (bytes + _s_round(n) == _m_top) {
+      _m_top = bytes;
+    }
+    return true;
+  }
+
+  std::size_t used() const noexcept { return static_cast<std::size_t>(_m_top - _m_begin); }
+
+  // the arena installed for this thread, nullptr if there is none
+  static coroutine_arena* current() noexcept { return _s_current; }
+  coroutine_arena* previous() const noexcept { return _m_prev; }
+
+ private:
+  // the first aligned address in [p, end], end when there is none
+  static std::byte* _s_align_up(std::byte* p, std::byte* end) noexcept {
+    constexpr std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    const auto skip = (align - reinterpret_cast<std::uintptr_t>(p) % align) % align;
+    return static_cast<std::size_t>(end - p) < skip ? end : p + skip;
+  }
+
+  static constexpr std::size_t _s_round(std::size_t n) noexcept {
+    constexpr std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    return (n + align - 1) & ~(align - 1);
+  }
+
+  std::byte* _m_begin;
+  std::byte* _m_top;
+  std::byte* _m_end;
+  coroutine_arena* _m_prev;
+  static inline thread_local coroutine_arena* _s_current = nullptr;
+};
+
+namespace details {
+
+inline coroutine_arena& default_coroutine_arena() noexcept {
+  alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) static thread_local std::byte buffer[NAVP_COROUTINE_ARENA_SIZE];
+  // installed below any caller provided arena
+  static thread_local coroutine_arena arena{std::span<std::byte>(buffer)};
+  return arena;
+}
+
+inline void* allocate_frame(std::size_t n) {
+  if (auto* arena = coroutine_arena::current(); arena != nullptr) {
+    if (void* p = arena->allocate(n)) {
+      return p;
+    }
+  } else if (void* p = default_coroutine_arena().allocate(n)) {
+    return p;
+  }
+  return ::operator new(n);
+}
+
+inline void deallocate_frame(void* p, std::size_t n) noexcept {
+  for (auto* arena = coroutine_arena::current(); arena != nullptr; arena = arena->previous()) {
+    if (arena->deallocate(p, n)) {
+      return;
+    }
+  }
+  ::operator delete(p, n);
+}
+
+// what a failure in a coroutine returning R panics with
+template <typename R>
+using coroutine_error_t = std::conditional_t<is_instance_of<R, Result>::value, result_error, option_error>;
+
+// the object returned from get_return_object(), the promise writes the outcome into it
+template <typename R>
+class coroutine_return {
+ public:
+  explicit coroutine_return(std::optional<R>*& slot) noexcept { slot = &_m_value; }
+  coroutine_return(const coroutine_return&) = delete;
+  coroutine_return& operator=(const coroutine_return&) = delete;
+
+  operator R() && {
+    if (!_m_value.has_value()) [[unlikely]] {
+      panic<coroutine_error_t<R>>("coroutine return object converted before the coroutine finished",
+                                  std::source_location::current());
+    }
+    return *std::move(_m_value);
+  }
+
+ private:
+  // std::optional, assigning an Option<T> to an Option<Option<T>> would flatten None
+  std::optional<R> _m_value;
+};
+
+// frame allocation and the parts common to both promise types
+template <typename R>
+class coroutine_promise_base {
+ public:
+  static void* operator new(std::size_t n) { return allocate_frame(n); }
+  static void operator delete(void* p, std::size_t n) noexcept { deallocate_frame(p, n); }
+
+  coroutine_return<R> get_return_object() noexcept { return coroutine_return<R>(_m_slot); }
+  std::suspend_never initial_suspend() const noexcept { return {}; }
+  std::suspend_never final_suspend() const noexcept { return {}; }
+  void unhandled_exception() const {
+#if defined(__cpp_exceptions)
+    throw;
+#else
+    std::terminate();
+#endif
+  }
+
+  template <typename... Args>
+  void _m_set(Args&&... args) {
+    _m_slot->emplace(std::forward<Args>(args)...);
+  }
+
+ private:
+  std::optional<R>* _m_slot = nullptr;
+};
+
+// co_await on an Err/None stores the failure in the return object and destroys the frame. An lvalue operand
+// (Awaited is const) is copied from, an rvalue one is moved from.
+template <typename Awaited, typename PromiseBase>
+struct bail_awaiter {
+  Awaited& awaited;
+
+  bool await_ready() const noexcept { return PromiseBase::_s_ready(awaited); }
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> h) {
+    if constexpr (std::is_const_v<Awaited>) {
+      h.promise()._m_bail(awaited);
+    } else {
+      h.promise()._m_bail(std::move(awaited));
+    }
+    h.destroy();
+  }
+
+  decltype(auto) await_resume() {
+    if constexpr (std::is_const_v<Awaited>) {
+      return PromiseBase::_s_value(awaited);
+    } else {
+      return PromiseBase::_s_value(std::move(awaited));
+    }
+  }
+};
+
+template <typename T, typename E>
+class result_promise_base : public coroutine_promise_base<Result<T, E>> {
+ public:
+  template <typename U, typename G>
+    requires std::is_constructible_v<E, G&&>
+  bail_awaiter<Result<U, G>, result_promise_base> await_transform(Result<U, G>&& r) noexcept {
+    return {r};
+  }
+  template <typename U, typename G>
+    requires std::is_constructible_v<E, const G&>
+  bail_awaiter<const Result<U, G>, result_promise_base> await_transform(const Result<U, G>& r) noexcept {
+    return {r};
+  }
+
+  template <typename R>
+  static bool _s_ready(const R& r) noexcept {
+    return r.is_ok();
+  }
+  template <typename R>
+  static decltype(auto) _s_value(R&& r) {
+    return std::forward<R>(r).unwrap_unchecked();
+  }
+  template <typename R>
+  void _m_bail(R&& r) {
+    this->_m_set(Err<E>(std::forward<R>(r).unwrap_err_unchecked()));
+  }
+};
+
+template <typename T>
+class option_promise_base : public coroutine_promise_base<Option<T>> {
+ public:
+  template <typename U>
+  bail_awaiter<Option<U>, option_promise_base> await_transform(Option<U>&& op) noexcept {
+    return {op};
+  }
+  template <typename U>
+  bail_awaiter<const Option<U>, option_promise_base> await_transform(const Option<U>& op) noexcept {
+    return {op};
+  }
+
+  template <typename O>
+  static bool _s_ready(const O& op) noexcept {
+    return op.is_some();
+  }
+  template <typename O>
+  static decltype(auto) _s_value(O&& op) {
+    return std::forward<O>(op).unwrap_unchecked();
+  }
+  template <typename O>
+  void _m_bail(O&&) {
+    this->_m_set(None);
+  }
+};
+
+template <typename T, typename E>
+struct result_promise : result_promise_base<T, E> {
+  template <typename U>
+    requires std::is_convertible_v<U&&, T>
+  void return_value(U&& val) {
+    this->_m_set(Ok<T>(std::forward<U>(val)));
+  }
+  // co_return Ok(x); or co_return Err(e);
+  template <typename U>
+  void return_value(Ok<U>&& ok) {
+    this->_m_set(std::move(ok));
+  }
+  template <typename G>
+  void return_value(Err<G>&& err) {
+    this->_m_set(std::move(err));
+  }
+};
+
+// a coroutine can't have both return_void and return_value, so it ends with `co_return Ok();` or `co_return Err(e);`
+template <typename E>
+struct result_promise<void, E> : result_promise_base<void, E> {
+  void return_value(Ok<void>) { this->_m_set(Ok<void>()); }
+  template <typename G>
+  void return_value(Err<G>&& err) {
+    this->_m_set(std::move(err));
+  }
+};
+
+template <typename T>
+struct option_promise : option_promise_base<T> {
+  template <typename U>
+    requires std::is_convertible_v<U&&, T>
+  void return_value(U&& val) {
+    this->_m_set(Option<T>(std::forward<U>(val)));
+  }
+  void return_value(NoneType) { this->_m_set(None); }
+};
+
+}  // namespace details
+
+}  // namespace navp
+
+template <typename T, typename E, typename... Args>
+struct std::coroutine_traits<navp::Result<T, E>, Args...> {
+  using promise_type = navp::details::result_promise<T, E>;
+};
+
+template <typename T, typename... Args>
+struct std::coroutine_traits<navp::Option<T>, Args...> {
+  using promise_type = navp::details::option_promise<T>;
+};
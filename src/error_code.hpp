@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "result.hpp"
+
+// ErrorCode: a 32-bit error value, a 16-bit domain id and a 16-bit code, so that Result<double, ErrorCode> is 16
+// bytes and trivially copyable. The text lives in a global registry of static message tables, one per domain, and
+// is only looked up when the error is displayed.
+//
+//   enum class parse_errc : std::uint16_t { empty, not_a_number };
+//   constexpr const char* parse_messages[] = {"empty input", "not a number"};
+//   inline const navp::error_domain parse_errors("parse", parse_messages);  // registers at startup
+//
+//   Result<double, ErrorCode> parse(std::string_view s) { ... return Err(parse_errors(parse_errc::empty)); }
+//   parse("").unwrap_err().to_string() == "parse: empty input"
+//
+// Registration and lookup are lock-free. Domain ids are handed out in registration order starting at 1, the
+// registry holds NAVP_ERROR_DOMAIN_CAPACITY - 1 domains. Id 0 is the domain of a default constructed ErrorCode.
+
+#ifndef NAVP_ERROR_DOMAIN_CAPACITY
+#define NAVP_ERROR_DOMAIN_CAPACITY 256
+#endif
+
+namespace navp {
+
+class error_domain;
+
+class ErrorCode {
+ public:
+  using domain_type = std::uint16_t;
+  using code_type = std::uint16_t;
+
+  constexpr ErrorCode() noexcept = default;
+  constexpr ErrorCode(domain_type domain, code_type code) noexcept
+      : _m_raw(static_cast<std::uint32_t>(domain) << 16 | code) {}
+
+  static constexpr ErrorCode from_raw(std::uint32_t raw) noexcept {
+    ErrorCode e;
+    e._m_raw = raw;
+    return e;
+  }
+
+  constexpr domain_type domain() const noexcept { return static_cast<domain_type>(_m_raw >> 16); }
+  constexpr code_type code() const noexcept { return static_cast<code_type>(_m_raw & 0xFFFFu); }
+  constexpr std::uint32_t raw() const noexcept { return _m_raw; }
+
+  // the registered message, "unknown error" for an unregistered domain or code
+  const char* message() const noexcept;
+  // the registered domain name, "unknown" for an unregistered domain
+  const char* domain_name() const noexcept;
+  // "<domain>: <message>"
+  std::string to_string() const;
+
+  constexpr bool operator==(const ErrorCode&) const noexcept = default;
+
+ private:
+  std::uint32_t _m_raw = 0;
+};
+
+static_assert(sizeof(ErrorCode) == 4 && std::is_trivially_copyable_v<ErrorCode>);
+static_assert(sizeof(Result<double, ErrorCode>) == 16 && std::is_trivially_copyable_v<Result<double, ErrorCode>>);
+
+namespace details {
+
+class error_registry {
+ public:
+  static constexpr std::size_t capacity = NAVP_ERROR_DOMAIN_CAPACITY;
+  static_assert(capacity > 1 && capacity <= 65536, "NAVP_ERROR_DOMAIN_CAPACITY must be in (1, 65536]");
+
+  static ErrorCode::domain_type add(const error_domain* domain) {
+    const auto id = _s_next.fetch_add(1, std::memory_order_relaxed);
+    if (id >= capacity) [[unlikely]] {
+      panic<result_error>("error domain registry is full, raise NAVP_ERROR_DOMAIN_CAPACITY",
+                          std::source_location::current());
+    }
+    _s_domains[id].store(domain, std::memory_order_release);
+    return static_cast<ErrorCode::domain_type>(id);
+  }
+
+  // nullptr when no domain has this id
+  static const error_domain* find(ErrorCode::domain_type id) noexcept {
+    return id < capacity ? _s_domains[id].load(std::memory_order_acquire) : nullptr;
+  }
+
+ private:
+  static inline std::atomic<std::size_t> _s_next{1};
+  static inline std::atomic<const error_domain*> _s_domains[capacity]{};
+};
+
+}  // namespace details
+
+// A named table of static messages indexed by code, registered when constructed. It must outlive every lookup,
+// e.g. a namespace-scope constant.
+class error_domain {
+ public:
+  error_domain(const char* name, std::span<const char* const> messages)
+      : _m_name(name), _m_messages(messages), _m_id(details::error_registry::add(this)) {}
+  error_domain(const error_domain&) = delete;
+  error_domain& operator=(const error_domain&) = delete;
+
+  ErrorCode::domain_type id() const noexcept { return _m_id; }
+  const char* name() const noexcept { return _m_name; }
+
+  // nullptr for a code without a message
+  const char* message(ErrorCode::code_type code) const noexcept {
+    return code < _m_messages.size() ? _m_messages[code] : nullptr;
+  }
+
+  ErrorCode operator()(ErrorCode::code_type code) const noexcept { return ErrorCode(_m_id, code); }
+  template <typename Enum>
+    requires std::is_enum_v<Enum>
+  ErrorCode operator()(Enum code) const noexcept {
+    return ErrorCode(_m_id, static_cast<ErrorCode::code_type>(code));
+  }
+
+ private:
+  const char* _m_name;
+  std::span<const char* const> _m_messages;
+  ErrorCode::domain_type _m_id;
+};
+
+inline const char* ErrorCode::message() const noexcept {
+  if (const auto* d = details::error_registry::find(domain()); d != nullptr) {
+    if (const char* msg = d->message(code()); msg != nullptr) {
+      return msg;
+    }
+  }
+  return "unknown error";
+}
+
+inline const char* ErrorCode::domain_name() const noexcept {
+  const auto* d = details::error_registry::find(domain());
+  return d != nullptr ? d->name() : "unknown";
+}
+
+inline std::string ErrorCode::to_string() const {
+  std::string out = domain_name();
+  out += ": ";
+  out += message();
+  return out;
+}
+
+}  // namespace navp
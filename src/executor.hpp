@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result.hpp"
+#include "result_vector.hpp"
+#include "template_utils.hpp"
+
+// TaskExecutor runs many independent Result-returning tasks and keeps every outcome.
+//
+// Tasks are identified by their index. Each worker owns a contiguous range of indices packed into one 64-bit
+// atomic (begin in the high half, end in the low half): the owner takes tasks from the front, and an idle worker
+// steals the back half of another worker's range with a single compare-exchange. Errors are pushed onto a
+// lock-free stack as they happen and sorted by index once all workers are done, so none is lost, and the Ok values
+// are written straight into their slot. The outcome is a ResultVector: every Ok value plus the (index, error) list.
+// Tasks returning Result<void, E>, such as validations, only produce the (index, error) list.
+
+namespace navp {
+
+namespace details {
+
+// [begin, end) packed into one word so owner and thieves can update it with one CAS
+class task_range {
+ public:
+  static constexpr std::size_t max_tasks = std::numeric_limits<std::uint32_t>::max();
+
+  void reset(std::size_t begin, std::size_t end) noexcept {
+    _m_word.store(_s_pack(begin, end), std::memory_order_release);
+  }
+
+  // take the first index, false when the range is empty
+  bool pop_front(std::size_t& i) noexcept {
+    auto word = _m_word.load(std::memory_order_acquire);
+    for (;;) {
+      const auto [begin, end] = _s_unpack(word);
+      if (begin >= end) {
+        return false;
+      }
+      if (_m_word.compare_exchange_weak(word, _s_pack(begin + 1, end), std::memory_order_acq_rel)) {
+        i = begin;
+        return true;
+      }
+    }
+  }
+
+  // take the back half (at least one index), false when the range is empty
+  bool steal_back(std::size_t& begin_out, std::size_t& end_out) noexcept {
+    auto word = _m_word.load(std::memory_order_acquire);
+    for (;;) {
+      const auto [begin, end] = _s_unpack(word);
+      if (begin >= end) {
+        return false;
+      }
+      const auto mid = end - (end - begin + 1) / 2;
+      if (_m_word.compare_exchange_weak(word, _s_pack(begin, mid), std::memory_order_acq_rel)) {
+        begin_out = mid;
+        end_out = end;
+        return true;
+      }
+    }
+  }
+
+ private:
+  static constexpr std::uint64_t _s_pack(std::size_t begin, std::size_t end) noexcept {
+    return (static_cast<std::uint64_t>(begin) << 32) | static_cast<std::uint64_t>(end);
+  }
+  static constexpr std::pair<std::size_t, std::size_t> _s_unpack(std::uint64_t word) noexcept {
+    return {static_cast<std::size_t>(word >> 32), static_cast<std::size_t>(word & 0xFFFFFFFFu)};
+  }
+
+  // each worker's range on its own cache line
+  alignas(64) std::atomic<std::uint64_t> _m_word{0};
+};
+
+// multi-producer push-only Treiber stack, drained by one thread after the producers are done
+template <typename E>
+class error_stack {
+ public:
+  error_stack() = default;
+  error_stack(const error_stack&) = delete;
+  error_stack& operator=(const error_stack&) = delete;
+  ~error_stack() {
+    for (auto* node = _m_head.load(std::memory_order_relaxed); node != nullptr;) {
+      delete std::exchange(node, node->next);
+    }
+  }
+
+  void push(std::size_t index, E&& err) {
+    auto* node = new error_node{index, std::move(err), _m_head.load(std::memory_order_relaxed)};
+    while (!_m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+  }
+
+  // the (index, error) pairs sorted by index, empties the stack
+  std::vector<std::pair<std::size_t, E>> drain() {
+    std::vector<std::pair<std::size_t, E>> out;
+    for (auto* node = _m_head.exchange(nullptr, std::memory_order_acquire); node != nullptr;) {
+      out.emplace_back(node->index, std::move(node->err));
+      delete std::exchange(node, node->next);
+    }
+    std::ranges::sort(out, {}, &std::pair<std::size_t, E>::first);
+    return out;
+  }
+
+ private:
+  struct error_node {
+    std::size_t index;
+    E err;
+    error_node* next;
+  };
+
+  std::atomic<error_node*> _m_head{nullptr};
+};
+
+// the Ok values of n tasks, written from several threads one element each (so not a std::vector<bool>), nothing for
+// Result<void, E> tasks
+template <typename T>
+struct task_values {
+  using type = typename OptionVector<T>::storage_type;
+};
+template <>
+struct task_values<void> {
+  struct type {
+    explicit type(std::size_t) noexcept {}
+  };
+};
+
+template <typename F>
+using task_result_t = std::remove_cvref_t<std::invoke_result_t<F&, std::size_t>>;
+
+}  // namespace details
+
+class TaskExecutor {
+ public:
+  // `threads` workers including the calling thread, 0 for std::thread::hardware_concurrency()
+  explicit TaskExecutor(unsigned threads = 0) noexcept
+      : _m_threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+  unsigned threads() const noexcept { return _m_threads; }
+
+  // run f(0) ... f(n - 1), each returning Result<T, E>
+  // gives a ResultVector<T, E>, or for T = void the (index, error) pairs of the failed tasks sorted by index
+  template <typename F>
+    requires details::is_instance_of<details::task_result_t<F>, Result>::value
+  auto run_indexed(std::size_t n, F&& f) const {
+    using result_t = details::task_result_t<F>;
+    using T = typename result_t::ok_type;
+    using E = typename result_t::err_type;
+    static_assert(std::is_void_v<T> || std::is_default_constructible_v<T>,
+                  "the ok type of a task must be void or default constructible");
+
+    if (n > details::task_range::max_tasks) {
+#if defined(__cpp_exceptions)
+      throw std::length_error("TaskExecutor: too many tasks");
+#else
+      std::fputs("TaskExecutor: too many tasks\n", stderr);
+      std::abort();
+#endif
+    }
+
+    typename details::task_values<T>::type values(n);
+    details::error_stack<E> errors;
+    const auto workers = static_cast<std::size_t>(std::min<std::size_t>(_m_threads, std::max<std::size_t>(n, 1)));
+    std::vector<details::task_range> ranges(workers);
+    for (std::size_t w = 0; w < workers; ++w) {
+      ranges[w].reset(n * w / workers, n * (w + 1) / workers);
+    }
+
+    std::atomic<bool> cancelled{false};
+#if defined(__cpp_exceptions)
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+#endif
+
+    auto run_one = [&](std::size_t i) {
+      auto r = f(i);
+      if (r.is_ok()) [[likely]] {
+        if constexpr (!std::is_void_v<T>) {
+          values[i] = std::move(r).unwrap_unchecked();
+        }
+      } else {
+        errors.push(i, std::move(r).unwrap_err_unchecked());
+      }
+    };
+
+    auto worker = [&](std::size_t self) {
+      auto& own = ranges[self];
+      for (;;) {
+        std::size_t i;
+        while (own.pop_front(i)) {
+          if (cancelled.load(std::memory_order_relaxed)) {
+            return;
+          }
+#if defined(__cpp_exceptions)
+          try {
+            run_one(i);
+          } catch (...) {
+            cancelled.store(true, std::memory_order_relaxed);
+            std::lock_guard lock(exception_mutex);
+            if (!exception) {
+              exception = std::current_exception();
+            }
+            return;
+          }
+#else
+          run_one(i);
+#endif
+        }
+        // own range is empty, steal from the others starting with the next worker
+        bool stolen = false;
+        for (std::size_t k = 1; k < workers && !stolen; ++k) {
+          std::size_t begin, end;
+          if (ranges[(self + k) % workers].steal_back(begin, end)) {
+            own.reset(begin, end);
+            stolen = true;
+          }
+        }
+        if (!stolen) {
+          return;
+        }
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      pool.reserve(workers - 1);
+      for (std::size_t w = 1; w < workers; ++w) {
+        pool.emplace_back(worker, w);
+      }
+      worker(0);
+    }
+
+#if defined(__cpp_exceptions)
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+#endif
+    if constexpr (std::is_void_v<T>) {
+      return errors.drain();
+    } else {
+      return ResultVector<T, E>(std::move(values), errors.drain());
+    }
+  }
+
+  // run every callable of `tasks`, each taking no argument and returning Result<T, E>
+  template <std::ranges::random_access_range R>
+    requires std::ranges::sized_range<R> && std::invocable<std::ranges::range_reference_t<R>>
+  auto run_all(R&& tasks) const {
+    const auto first = std::ranges::begin(tasks);
+    return run_indexed(static_cast<std::size_t>(std::ranges::size(tasks)), [&](std::size_t i) {
+      return std::invoke(first[static_cast<std::ranges::range_difference_t<R>>(i)]);
+    });
+  }
+
+ private:
+  unsigned _m_threads;
+};
+
+}  // namespace navp
@@ -1,22 +1,78 @@
 #pragma once
 
-#include <cpptrace/cpptrace.hpp>
+#include <bit>
+#include <concepts>
+#include <functional>
+#include <limits>
 #include <variant>
 
+#include "panic.hpp"
 #include "template_utils.hpp"
 
 namespace navp {
 
-class option_error : public std::runtime_error {
-  using std::runtime_error::runtime_error;
+class option_error : public traced_error {
+  using traced_error::traced_error;
 };
 
+namespace details {
+
+// out-of-line failure paths, keeps unwrap()/expect() down to a test and a load at the call site
+[[noreturn, gnu::cold, gnu::noinline]] inline void panic_unwrap_none(std::source_location loc) {
+  panic<option_error>("unwrap a none option!", loc);
+}
+[[noreturn, gnu::cold, gnu::noinline]] inline void panic_expect_none(panic_message msg, std::source_location loc) {
+  panic<option_error>(msg, loc);
+}
+
+}  // namespace details
+
 template <typename T, typename E>
 class Result;
 
 template <typename T>
 class Option;
 
+// niche_traits
+// Specialize it to let Option<T> use a spare value of T as None, then Option<T> has the same size as T.
+// A specialization provides:
+//   static constexpr T none() noexcept;                   the value stored for None
+//   static constexpr bool is_none(const T& val) noexcept; whether `val` is that value
+// Note that Some(none()) is indistinguishable from None.
+template <typename T>
+struct niche_traits {};
+
+// nullptr is None
+template <typename T>
+struct niche_traits<T*> {
+  static constexpr T* none() noexcept { return nullptr; }
+  static constexpr bool is_none(T* val) noexcept { return val == nullptr; }
+};
+
+// std::reference_wrapper can't be null, but its representation is a single pointer
+template <typename T>
+struct niche_traits<std::reference_wrapper<T>> {
+  static_assert(sizeof(std::reference_wrapper<T>) == sizeof(T*));
+
+  static std::reference_wrapper<T> none() noexcept { return std::bit_cast<std::reference_wrapper<T>>((T*)nullptr); }
+  static bool is_none(const std::reference_wrapper<T>& val) noexcept { return std::bit_cast<T*>(val) == nullptr; }
+};
+
+// NaN is None, for floating point types
+template <typename T>
+  requires std::is_floating_point_v<T>
+struct nan_niche {
+  static constexpr T none() noexcept { return std::numeric_limits<T>::quiet_NaN(); }
+  static constexpr bool is_none(T val) noexcept { return val != val; }
+};
+
+// a fixed value is None, e.g. INT_MIN or an `Invalid` enumerator
+template <typename T, T Sentinel>
+struct sentinel_niche {
+  static constexpr T none() noexcept { return Sentinel; }
+  static constexpr bool is_none(T val) noexcept { return val == Sentinel; }
+};
+
 namespace details {
 
 struct NoneType {
@@ -26,6 +82,71 @@ struct NoneType {
 template <typename T>
 using not_tag = std::__not_<std::is_same<std::remove_cv<T>, NoneType>>;
 
+// storage with a separate discriminant
+template <typename T>
+class option_variant_storage {
+ public:
+  constexpr option_variant_storage() noexcept : _m_val(std::in_place_index_t<1>{}) {}
+
+  template <typename... Args>
+  explicit constexpr option_variant_storage(std::in_place_t, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : _m_val(std::in_place_index_t<0>{}, std::forward<Args>(args)...) {}
+
+  constexpr bool _m_has_value() const noexcept { return _m_val.index() == 0; }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    _m_val.template emplace<0>(std::forward<Args>(args)...);
+  }
+
+  constexpr void _m_reset() noexcept { _m_val.template emplace<1>(); }
+
+  constexpr T& _m_value() & { return std::get<0>(_m_val); }
+  constexpr const T& _m_value() const& { return std::get<0>(_m_val); }
+
+ private:
+  std::variant<T, NoneType> _m_val;
+};
+
+// storage for types with a niche, niche_traits<T>::none() is None
+template <typename T>
+class option_niche_storage {
+  using traits = niche_traits<T>;
+
+ public:
+  constexpr option_niche_storage() noexcept : _m_val(traits::none()) {}
+
+  template <typename... Args>
+  explicit constexpr option_niche_storage(std::in_place_t, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : _m_val(std::forward<Args>(args)...) {}
+
+  constexpr bool _m_has_value() const noexcept { return !traits::is_none(_m_val); }
+
+  template <typename... Args>
+  constexpr void _m_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    _m_val = T(std::forward<Args>(args)...);
+  }
+
+  constexpr void _m_reset() noexcept { _m_val = traits::none(); }
+
+  constexpr T& _m_value() & noexcept { return _m_val; }
+  constexpr const T& _m_value() const& noexcept { return _m_val; }
+
+ private:
+  T _m_val;
+};
+
+template <typename T>
+concept has_niche = requires(const T& val) {
+  { niche_traits<T>::none() } noexcept -> std::same_as<T>;
+  { niche_traits<T>::is_none(val) } noexcept -> std::same_as<bool>;
+};
+
+template <typename T>
+using option_storage = std::conditional_t<has_niche<T>, option_niche_storage<T>, option_variant_storage<T>>;
+
 }  // namespace details
 
 constexpr details::NoneType None{};
@@ -38,7 +159,7 @@ using __converts_from_option =
                std::is_convertible<const Option<_Up>&&, _Tp>, std::is_convertible<Option<_Up>&&, _Tp>>;
 
 template <typename T>
-class Option : private std::variant<T, details::NoneType> {
+class Option : private details::option_storage<T> {
  private:
   template <typename _Up>
   using __not_self = std::__not_<std::is_same<Option, std::__remove_cvref_t<_Up>>>;
@@ -55,9 +176,11 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename U>
   using not_variant = _not<details::is_instance_of<rmcv_ref_t<U>, std::variant>>;
 
-  using _Base = std::variant<T, details::NoneType>;
+  using _Base = details::option_storage<T>;
 
  public:
+  using value_type = T;
+
   // operator ()
   constexpr operator bool() const noexcept { return is_some(); }
 
@@ -96,7 +219,7 @@ class Option : private std::variant<T, details::NoneType> {
     return is_some() ? is_some() : false;
   }
 
-  constexpr Option() noexcept : std::variant<T, details::NoneType>(details::NoneType{}) {}
+  constexpr Option() noexcept : _Base() {}
   Option(const Option&) = default;
   Option(Option&&) = default;
   Option& operator=(const Option&) = default;
@@ -107,12 +230,12 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename U = T, _Requires<__not_self<U>, details::not_tag<U>, not_option<U>, not_variant<U>,
                                       std::is_constructible<T, U>, std::is_convertible<U, T>> = true>
   constexpr Option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>)
-      : std::variant<T, details::NoneType>(static_cast<T>(std::forward<U>(val))) {}
+      : _Base(std::in_place, static_cast<T>(std::forward<U>(val))) {}
 
   template <typename U = T, _Requires<__not_self<U>, details::not_tag<U>, not_option<U>, not_variant<U>,
                                       std::is_constructible<T, U>, _not<std::is_convertible<U, T>>> = false>
   explicit constexpr Option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>)
-      : std::variant<T, details::NoneType>(std::forward<U>(val)) {}
+      : _Base(std::in_place, std::forward<U>(val)) {}
 
   // construct form Option<U>
   template <typename U, _Requires<_not<std::is_same<U, T>>, std::is_constructible<T, const U&>,
@@ -121,7 +244,7 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = T(other.unwrap());
     }
   }
@@ -132,7 +255,7 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = T(other.unwrap());
     }
   }
@@ -143,7 +266,7 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = std::move(T(other.unwrap()));
     }
   }
@@ -154,7 +277,7 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
       // *this = std::move(T(other.unwrap()));
     }
   }
@@ -162,20 +285,20 @@ class Option : private std::variant<T, details::NoneType> {
   // construct in_place
   template <typename... Args, _Requires<std::is_constructible<T, Args...>> = false>
   explicit constexpr Option(std::in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
-      : std::variant<T, details::NoneType>(std::in_place_index_t<0>{}, std::forward<Args>(args)...) {}
+      : _Base(std::in_place, std::forward<Args>(args)...) {}
 
   template <typename U, typename... Args,
             _Requires<std::is_constructible<T, std::initializer_list<U>&, Args...>> = false>
   explicit constexpr Option(std::in_place_t, std::initializer_list<U> list, Args&&... args) noexcept(
       std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>)
-      : std::variant<T, details::NoneType>(std::in_place_index_t<0>{}, list, std::forward<Args>(args)...) {}
+      : _Base(std::in_place, list, std::forward<Args>(args)...) {}
 
   // from NoneType
-  constexpr Option(details::NoneType) noexcept : std::variant<T, details::NoneType>(details::NoneType{}) {}
+  constexpr Option(details::NoneType) noexcept : _Base() {}
 
   // assign
   constexpr Option& operator=(details::NoneType) noexcept {
-    *static_cast<_Base*>(this) = None;
+    this->_m_reset();
     return *this;
   }
 
@@ -184,7 +307,7 @@ class Option : private std::variant<T, details::NoneType> {
                                       std::is_constructible<T, U>, std::is_assignable<T&, U>> = true>
   constexpr Option& operator=(U&& val) noexcept(std::is_nothrow_constructible_v<T, U> &&
                                                 std::is_nothrow_assignable_v<T&, U>) {
-    this->template emplace<0>(std::forward<U>(val));
+    this->_m_emplace(std::forward<U>(val));
     return *this;
   }
 
@@ -195,7 +318,7 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(other.unwrap());
+      this->_m_emplace(other.unwrap());
     }
     return *this;
   }
@@ -207,22 +330,28 @@ class Option : private std::variant<T, details::NoneType> {
     if (other.is_none()) {
       *this = None;
     } else {
-      this->template emplace<0>(std::move(other.unwrap()));
+      this->_m_emplace(std::move(other.unwrap()));
     }
     return *this;
   }
 
+  // the cases the overload above rejects: a scalar of the same type, or a T that is not assignable from U
   template <typename U = T, _Requires<__not_self<U>, details::not_tag<U>,
                                       _not<details::is_instance_of<std::__remove_cvref_t<U>, Option>>,
                                       _not<details::is_instance_of<std::__remove_cvref_t<U>, std::variant>>,
-                                      std::is_constructible<T, U>, std::is_convertible<U, T>> = true>
-  constexpr Option& operator=(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>) {}
+                                      std::is_constructible<T, U>, std::is_convertible<U, T>,
+                                      std::__or_<_and<std::is_scalar<T>, std::is_same<T, std::decay_t<U>>>,
+                                                 _not<std::is_assignable<T&, U>>>> = true>
+  constexpr Option& operator=(U&& val) noexcept(std::is_nothrow_constructible_v<T, U>) {
+    this->_m_emplace(std::forward<U>(val));
+    return *this;
+  }
 
   // is_some
-  constexpr bool is_some() const noexcept { return this->index() == 0; }
+  constexpr bool is_some() const noexcept { return this->_m_has_value(); }
 
   // is_none
-  constexpr bool is_none() const noexcept { return this->index() == 1; }
+  constexpr bool is_none() const noexcept { return !this->_m_has_value(); }
 
   // is_some_and
   template <typename F>
@@ -266,14 +395,14 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, Option&> insert(Args&&... args) & noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
-    this->template emplace<0>(std::forward<Args>(args)...);
+    this->_m_emplace(std::forward<Args>(args)...);
     return *this;
   }
   template <typename U, typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, std::initializer_list<U>&, Args...>, Option&> insert(
       std::initializer_list<U> list,
       Args&&... args) & noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
-    this->template emplace<0>(list, std::forward<Args>(args)...);
+    this->_m_emplace(list, std::forward<Args>(args)...);
     return *this;
   }
 
@@ -282,7 +411,7 @@ class Option : private std::variant<T, details::NoneType> {
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, T&> get_or_insert(Args&&... args) & noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
     if (is_none()) {
-      this->template emplace<0>(std::forward<Args>(args)...);
+      this->_m_emplace(std::forward<Args>(args)...);
     }
     return _m_get_some_value();
   }
@@ -291,7 +420,7 @@ class Option : private std::variant<T, details::NoneType> {
       std::initializer_list<U> list,
       Args&&... args) & noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
     if (is_none()) {
-      this->template emplace<0>(list, std::forward<Args>(args)...);
+      this->_m_emplace(list, std::forward<Args>(args)...);
     }
     return _m_get_some_value();
   }
@@ -318,32 +447,30 @@ class Option : private std::variant<T, details::NoneType> {
   template <typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, Args...>, T&> replace(Args&&... args) noexcept(
       std::is_nothrow_constructible_v<T, Args...>) {
-    this->template emplace<0>(std::forward<Args>(args)...);
+    this->_m_emplace(std::forward<Args>(args)...);
     return _m_get_some_value();
   }
   template <typename U, typename... Args>
   constexpr std::enable_if_t<std::is_constructible_v<T, std::initializer_list<U>&, Args...>, T&> replace(
       std::initializer_list<U> list,
       Args&&... args) noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) {
-    this->template emplace<0>(list, std::forward<Args>(args)...);
+    this->_m_emplace(list, std::forward<Args>(args)...);
     return _m_get_some_value();
   }
 
   // unwrap
-  constexpr T& unwrap() const& {
-    if (is_some()) {
+  constexpr T& unwrap(std::source_location loc = std::source_location::current()) const& {
+    if (is_some()) [[likely]] {
       return const_cast<T&>(_m_get_some_value());
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      details::panic_unwrap_none(loc);
     }
   }
-  constexpr T&& unwrap() && {
-    if (is_some()) {
+  constexpr T&& unwrap(std::source_location loc = std::source_location::current()) && {
+    if (is_some()) [[likely]] {
       return std::move(_m_get_some_value());
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw option_error("unwrap a none option!");
+      details::panic_unwrap_none(loc);
     }
   }
 
@@ -383,22 +510,20 @@ class Option : private std::variant<T, details::NoneType> {
 
   // unwrap_unchecked
   constexpr T& unwrap_unchecked() const& { return const_cast<T&>(_m_get_some_value()); }
-  constexpr T&& unwrap_unchecked() && { return _m_get_some_value(); }
+  constexpr T&& unwrap_unchecked() && { return std::move(_m_get_some_value()); }
 
-  // expected
-  constexpr T& expect(const char* msg) const& {
-    if (is_some()) {
+  // expected, a string literal `msg` is kept by pointer and any other string is copied
+  constexpr T& expect(details::panic_message msg, std::source_location loc = std::source_location::current()) const& {
+    if (is_some()) [[likely]] {
       return const_cast<T&>(_m_get_some_value());
     }
-    cpptrace::generate_trace(1).print_with_snippets();
-    throw option_error(msg);
+    details::panic_expect_none(msg, loc);
   }
-  constexpr T&& expect(const char* msg) && {
-    if (is_some()) {
+  constexpr T&& expect(details::panic_message msg, std::source_location loc = std::source_location::current()) && {
+    if (is_some()) [[likely]] {
       return std::move(_m_get_some_value());
     }
-    cpptrace::generate_trace(1).print_with_snippets();
-    throw option_error(msg);
+    details::panic_expect_none(msg, loc);
   }
 
   // map
@@ -457,22 +582,23 @@ class Option : private std::variant<T, details::NoneType> {
 
  protected:
   // unchecked get value
-  constexpr inline const T& _m_get_some_value() const& { return std::get<T>(*this); }
-  constexpr inline T& _m_get_some_value() & { return std::get<T>(*this); }
-  constexpr inline T&& _m_get_some_value() && { return std::move(std::get<T>(*this)); }
-  constexpr inline const T&& _m_get_some_value() const&& { return std::move(std::get<T>(*this)); }
+  constexpr inline const T& _m_get_some_value() const& { return this->_m_value(); }
+  constexpr inline T& _m_get_some_value() & { return this->_m_value(); }
+  constexpr inline T&& _m_get_some_value() && { return std::move(this->_m_value()); }
+  constexpr inline const T&& _m_get_some_value() const&& { return std::move(this->_m_value()); }
 };
 
-// from r value
+// from r value, or a non-const l value
 template <typename T>
-constexpr Option<T> Some(T&& _val) noexcept {
-  return Option<T>(_val);
+constexpr Option<std::remove_cvref_t<T>> Some(T&& _val) noexcept(
+    std::is_nothrow_constructible_v<std::remove_cvref_t<T>, T>) {
+  return Option<std::remove_cvref_t<T>>(std::forward<T>(_val));
 }
 
 // from l value
 template <typename T>
-constexpr Option<T> Some(const T& _val) noexcept {
-  return Option<T>(std::move(_val));
+constexpr Option<T> Some(const T& _val) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+  return Option<T>(_val);
 }
 
 // construct in_place
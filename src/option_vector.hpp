@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+
+namespace navp {
+
+namespace details {
+
+// the values of an OptionVector<bool>, one bool per byte with the part of the std::vector interface OptionVector
+// uses: std::vector<bool> packs bits, so it has no bool& and no data(), and two threads cannot write neighbouring
+// elements
+class bool_values {
+ public:
+  bool_values() = default;
+  explicit bool_values(std::size_t n, bool val = false) { resize(n, val); }
+
+  bool_values(const bool_values& other) {
+    reserve(other._m_size);
+    std::copy_n(other._m_data.get(), other._m_size, _m_data.get());
+    _m_size = other._m_size;
+  }
+  bool_values(bool_values&& other) noexcept
+      : _m_data(std::move(other._m_data)),
+        _m_size(std::exchange(other._m_size, 0)),
+        _m_capacity(std::exchange(other._m_capacity, 0)) {}
+  bool_values& operator=(const bool_values& other) {
+    if (this != &other) {
+      *this = bool_values(other);
+    }
+    return *this;
+  }
+  bool_values& operator=(bool_values&& other) noexcept {
+    if (this != &other) {
+      _m_data = std::move(other._m_data);
+      _m_size = std::exchange(other._m_size, 0);
+      _m_capacity = std::exchange(other._m_capacity, 0);
+    }
+    return *this;
+  }
+
+  std::size_t size() const noexcept { return _m_size; }
+  bool empty() const noexcept { return _m_size == 0; }
+
+  void reserve(std::size_t n) {
+    if (n > _m_capacity) {
+      auto data = std::make_unique<bool[]>(n);
+      std::copy_n(_m_data.get(), _m_size, data.get());
+      _m_data = std::move(data);
+      _m_capacity = n;
+    }
+  }
+  void resize(std::size_t n, bool val = false) {
+    reserve(n);
+    if (n > _m_size) {
+      std::fill(_m_data.get() + _m_size, _m_data.get() + n, val);
+    }
+    _m_size = n;
+  }
+  void clear() noexcept { _m_size = 0; }
+
+  void push_back(bool val) { emplace_back(val); }
+  template <typename... Args>
+  bool& emplace_back(Args&&... args) {
+    if (_m_size == _m_capacity) {
+      reserve(std::max<std::size_t>(16, 2 * _m_capacity));
+    }
+    _m_data[_m_size] = bool(std::forward<Args>(args)...);
+    return _m_data[_m_size++];
+  }
+  void pop_back() noexcept { --_m_size; }
+
+  bool& operator[](std::size_t i) noexcept { return _m_data[i]; }
+  const bool& operator[](std::size_t i) const noexcept { return _m_data[i]; }
+  bool* data() noexcept { return _m_data.get(); }
+  const bool* data() const noexcept { return _m_data.get(); }
+
+ private:
+  std::unique_ptr<bool[]> _m_data;
+  std::size_t _m_size = 0;
+  std::size_t _m_capacity = 0;
+};
+
+template <typename T>
+struct option_vector_storage {
+  using type = std::vector<T>;
+};
+template <>
+struct option_vector_storage<bool> {
+  using type = bool_values;
+};
+
+}  // namespace details
+
+// OptionVector
+// A sequence of Option<T> stored as a structure of arrays: the values are contiguous and presence is kept in a
+// validity bitmap with one bit per element (bit i of word i / 64, like the Arrow null bitmap). A None slot holds a
+// value-initialized T, and bits past size() are always zero. The values are a std::vector<T>, except for bool,
+// which keeps one bool per byte in details::bool_values.
+template <typename T>
+class OptionVector {
+  static_assert(std::is_default_constructible_v<T>, "OptionVector<T> needs a default constructible T for None slots");
+
+ public:
+  using value_type = Option<T>;
+  using size_type = std::size_t;
+  using storage_type = typename details::option_vector_storage<T>::type;
+  using word_type = std::uint64_t;
+  static constexpr size_type word_bits = 64;
+
+  class const_iterator;
+
+  OptionVector() = default;
+
+  // n None elements
+  explicit OptionVector(size_type n) : _m_values(n), _m_bitmap(_s_words(n), 0) {}
+
+  // n copies of Some(val)
+  OptionVector(size_type n, const T& val) : _m_values(n, val), _m_bitmap(_s_words(n), ~word_type{0}) {
+    _m_clear_tail();
+  }
+
+  // every element Some
+  explicit OptionVector(storage_type values)
+      : _m_values(std::move(values)), _m_bitmap(_s_words(_m_values.size()), ~word_type{0}) {
+    _m_clear_tail();
+  }
+
+  OptionVector(std::initializer_list<Option<T>> list) {
+    reserve(list.size());
+    for (const auto& op : list) {
+      push_back(op);
+    }
+  }
+
+  // capacity
+  size_type size() const noexcept { return _m_values.size(); }
+  bool empty() const noexcept { return _m_values.empty(); }
+  void reserve(size_type n) {
+    _m_values.reserve(n);
+    _m_bitmap.reserve(_s_words(n));
+  }
+
+  // new elements are None
+  void resize(size_type n) {
+    _m_values.resize(n);
+    _m_bitmap.resize(_s_words(n), 0);
+    _m_clear_tail();
+  }
+
+  void clear() noexcept {
+    _m_values.clear();
+    _m_bitmap.clear();
+  }
+
+  // modifiers
+  void push_back(const T& val) {
+    _m_values.push_back(val);
+    _m_push_bit(true);
+  }
+  void push_back(T&& val) {
+    _m_values.push_back(std::move(val));
+    _m_push_bit(true);
+  }
+  void push_back(details::NoneType) {
+    _m_values.emplace_back();
+    _m_push_bit(false);
+  }
+  void push_back(const Option<T>& op) {
+    if (op.is_some()) {
+      push_back(op.unwrap_unchecked());
+    } else {
+      push_back(None);
+    }
+  }
+  void push_back(Option<T>&& op) {
+    if (op.is_some()) {
+      push_back(std::move(op.unwrap_unchecked()));
+    } else {
+      push_back(None);
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    auto& val = _m_values.emplace_back(std::forward<Args>(args)...);
+    _m_push_bit(true);
+    return val;
+  }
+
+  void pop_back() {
+    _m_set_bit(size() - 1, false);
+    _m_values.pop_back();
+    if (_s_words(size()) < _m_bitmap.size()) {
+      _m_bitmap.pop_back();
+    }
+  }
+
+  void set(size_type i, const T& val) {
+    _m_values[i] = val;
+    _m_set_bit(i, true);
+  }
+  void set(size_type i, T&& val) {
+    _m_values[i] = std::move(val);
+    _m_set_bit(i, true);
+  }
+  void set(size_type i, details::NoneType) {
+    _m_values[i] = T();
+    _m_set_bit(i, false);
+  }
+  void set(size_type i, const Option<T>& op) {
+    if (op.is_some()) {
+      set(i, op.unwrap_unchecked());
+    } else {
+      set(i, None);
+    }
+  }
+
+  // element access
+  bool is_some(size_type i) const noexcept { return (_m_bitmap[i / word_bits] >> (i % word_bits)) & 1u; }
+  bool is_none(size_type i) const noexcept { return !is_some(i); }
+
+  Option<T> operator[](size_type i) const { return is_some(i) ? Option<T>(_m_values[i]) : Option<T>(None); }
+  Option<T> at(size_type i) const {
+    if (i >= size()) {
+      throw std::out_of_range("OptionVector::at");
+    }
+    return (*this)[i];
+  }
+
+  // the value in slot i, a value-initialized T when it is None
+  T& value_unchecked(size_type i) noexcept { return _m_values[i]; }
+  const T& value_unchecked(size_type i) const noexcept { return _m_values[i]; }
+
+  // number of Some elements
+  size_type count_some() const noexcept {
+    size_type n = 0;
+    for (auto word : _m_bitmap) {
+      n += static_cast<size_type>(std::popcount(word));
+    }
+    return n;
+  }
+  size_type count_none() const noexcept { return size() - count_some(); }
+
+  // raw storage, for bulk kernels
+  T* values() noexcept { return _m_values.data(); }
+  const T* values() const noexcept { return _m_values.data(); }
+  const word_type* bitmap() const noexcept { return _m_bitmap.data(); }
+  // writers must keep the bits past size() zero
+  word_type* bitmap() noexcept { return _m_bitmap.data(); }
+  size_type bitmap_words() const noexcept { return _m_bitmap.size(); }
+
+  // iteration yields Option<T> by value
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+  class const_iterator {
+   public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Option<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = Option<T>;
+
+    const_iterator() = default;
+
+    reference operator*() const { return (*_m_vec)[_m_pos]; }
+    reference operator[](difference_type n) const { return (*_m_vec)[_m_pos + n]; }
+
+    const_iterator& operator++() noexcept {
+      ++_m_pos;
+      return *this;
+    }
+    const_iterator operator++(int) noexcept {
+      auto tmp = *this;
+      ++_m_pos;
+      return tmp;
+    }
+    const_iterator& operator--() noexcept {
+      --_m_pos;
+      return *this;
+    }
+    const_iterator operator--(int) noexcept {
+      auto tmp = *this;
+      --_m_pos;
+      return tmp;
+    }
+    const_iterator& operator+=(difference_type n) noexcept {
+      _m_pos += n;
+      return *this;
+    }
+    const_iterator& operator-=(difference_type n) noexcept {
+      _m_pos -= n;
+      return *this;
+    }
+    friend const_iterator operator+(const_iterator it, difference_type n) noexcept { return it += n; }
+    friend const_iterator operator+(difference_type n, const_iterator it) noexcept { return it += n; }
+    friend const_iterator operator-(const_iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+      return static_cast<difference_type>(lhs._m_pos) - static_cast<difference_type>(rhs._m_pos);
+    }
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+      return lhs._m_pos == rhs._m_pos;
+    }
+    friend auto operator<=>(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+      return lhs._m_pos <=> rhs._m_pos;
+    }
+
+   private:
+    friend class OptionVector;
+    const_iterator(const OptionVector* vec, size_type pos) noexcept : _m_vec(vec), _m_pos(pos) {}
+
+    const OptionVector* _m_vec = nullptr;
+    size_type _m_pos = 0;
+  };
+
+ private:
+  static constexpr size_type _s_words(size_type n) noexcept { return (n + word_bits - 1) / word_bits; }
+
+  void _m_push_bit(bool some) {
+    const auto i = size() - 1;
+    if (_s_words(size()) > _m_bitmap.size()) {
+      _m_bitmap.push_back(0);
+    }
+    _m_set_bit(i, some);
+  }
+
+  void _m_set_bit(size_type i, bool some) noexcept {
+    const auto mask = word_type{1} << (i % word_bits);
+    if (some) {
+      _m_bitmap[i / word_bits] |= mask;
+    } else {
+      _m_bitmap[i / word_bits] &= ~mask;
+    }
+  }
+
+  // zero the bits past size() in the last word
+  void _m_clear_tail() noexcept {
+    if (const auto rem = size() % word_bits; rem != 0) {
+      _m_bitmap.back() &= (word_type{1} << rem) - 1;
+    }
+  }
+
+  storage_type _m_values;
+  std::vector<word_type> _m_bitmap;
+};
+
+}  // namespace navp
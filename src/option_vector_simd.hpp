@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "option_vector.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(NAVP_NO_SIMD)
+#define NAVP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Bulk operations over OptionVector, the batch forms of Option::map, Option::unwrap_or and friends. They walk the
+// validity bitmap a word at a time instead of branching on every element. For OptionVector<double> the reductions
+// and unwrap_or have AVX2 and AVX-512 kernels chosen once at runtime with __builtin_cpu_supports, other types use
+// the portable loops. Define NAVP_NO_SIMD to always use the portable loops.
+
+namespace navp {
+
+enum class simd_level { scalar, avx2, avx512 };
+
+namespace details {
+
+inline simd_level detect_simd_level() noexcept {
+#ifdef NAVP_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return simd_level::avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return simd_level::avx2;
+  }
+#endif
+  return simd_level::scalar;
+}
+
+// call f(i) for every set bit i in the first `words` words of `bitmap`
+template <typename F>
+inline void for_each_some(const std::uint64_t* bitmap, std::size_t words, F&& f) {
+  for (std::size_t k = 0; k < words; ++k) {
+    for (auto w = bitmap[k]; w != 0; w &= w - 1) {
+      f(k * 64 + static_cast<std::size_t>(std::countr_zero(w)));
+    }
+  }
+}
+
+// portable kernels
+
+// accumulated in Acc, T by default
+template <typename T, typename Acc = T>
+inline Acc sum_some_scalar(const T* v, const std::uint64_t* bitmap, std::size_t n) noexcept {
+  Acc acc{};
+  const std::size_t words = (n + 63) / 64;
+  for (std::size_t k = 0; k < words; ++k) {
+    if (const auto w = bitmap[k]; w == ~std::uint64_t{0}) {
+      // dense word, no per-element test
+      for (std::size_t i = k * 64; i < k * 64 + 64; ++i) {
+        acc += v[i];
+      }
+    } else {
+      for (auto m = w; m != 0; m &= m - 1) {
+        acc += v[k * 64 + static_cast<std::size_t>(std::countr_zero(m))];
+      }
+    }
+  }
+  return acc;
+}
+
+// the start of a min (Max = false) or max reduction: an infinity for floating point, so that a Some infinity is
+// returned as such, like the SIMD kernels do
+template <typename T, bool Max>
+constexpr T extreme_init() noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    return Max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+  } else {
+    return Max ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+  }
+}
+
+// the accumulator of mean_some: double for floating point; for integers 64 bits, or 128 bits for 8-byte integers, so
+// that the sum of the integers is exact
+__extension__ using int128_t = __int128;
+__extension__ using uint128_t = unsigned __int128;
+
+template <typename T>
+using mean_acc_t = std::conditional_t<
+    std::is_floating_point_v<T>, double,
+    std::conditional_t<(sizeof(T) < 8), std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+                       std::conditional_t<std::is_signed_v<T>, int128_t, uint128_t>>>;
+
+// smallest (Less = std::less) or largest value of the Some elements, `init` when there is none
+template <typename T, typename Less>
+inline T extreme_some_scalar(const T* v, const std::uint64_t* bitmap, std::size_t n, T init, Less less) noexcept {
+  T acc = init;
+  for_each_some(bitmap, (n + 63) / 64, [&](std::size_t i) {
+    if (less(v[i], acc)) {
+      acc = v[i];
+    }
+  });
+  return acc;
+}
+
+template <typename T>
+inline void unwrap_or_scalar(const T* v, const std::uint64_t* bitmap, std::size_t n, const T& def, T* out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = ((bitmap[i / 64] >> (i % 64)) & 1u) ? v[i] : def;
+  }
+}
+
+#ifdef NAVP_X86_SIMD
+
+// AVX2 kernels, 4 lanes per step; the mask of a step is 4 bitmap bits spread to 64-bit lanes
+
+[[gnu::target("avx2")]] inline __m256d mask4_avx2(const std::uint64_t* bitmap, std::size_t i) noexcept {
+  const auto bits = static_cast<long long>((bitmap[i / 64] >> (i % 64)) & 0xF);
+  const auto sel = _mm256_setr_epi64x(1, 2, 4, 8);
+  return _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), sel), sel));
+}
+
+[[gnu::target("avx2")]] inline double hsum_avx2(__m256d x) noexcept {
+  const auto pair = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+[[gnu::target("avx2")]] inline double sum_some_avx2(const double* v, const std::uint64_t* bitmap,
+                                                     std::size_t n) noexcept {
+  auto acc = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_and_pd(mask4_avx2(bitmap, i), _mm256_loadu_pd(v + i)));
+  }
+  double sum = hsum_avx2(acc);
+  for (; i < n; ++i) {
+    if ((bitmap[i / 64] >> (i % 64)) & 1u) {
+      sum += v[i];
+    }
+  }
+  return sum;
+}
+
+template <bool Max>
+[[gnu::target("avx2")]] inline double extreme_some_avx2(const double* v, const std::uint64_t* bitmap,
+                                                         std::size_t n) noexcept {
+  constexpr double init = Max ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+  const auto fill = _mm256_set1_pd(init);
+  auto acc = fill;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const auto x = _mm256_blendv_pd(fill, _mm256_loadu_pd(v + i), mask4_avx2(bitmap, i));
+    acc = Max ? _mm256_max_pd(acc, x) : _mm256_min_pd(acc, x);
+  }
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, acc);
+  double r = init;
+  for (double x : lanes) {
+    r = Max ? std::max(r, x) : std::min(r, x);
+  }
+  for (; i < n; ++i) {
+    if ((bitmap[i / 64] >> (i % 64)) & 1u) {
+      r = Max ? std::max(r, v[i]) : std::min(r, v[i]);
+    }
+  }
+  return r;
+}
+
+[[gnu::target("avx2")]] inline void unwrap_or_avx2(const double* v, const std::uint64_t* bitmap, std::size_t n,
+                                                    double def, double* out) noexcept {
+  const auto fill = _mm256_set1_pd(def);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_blendv_pd(fill, _mm256_loadu_pd(v + i), mask4_avx2(bitmap, i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = ((bitmap[i / 64] >> (i % 64)) & 1u) ? v[i] : def;
+  }
+}
+
+// AVX-512 kernels, 8 lanes per step; a bitmap byte is the lane mask. Bits past the end are zero, so the masked
+// loads of the last step never touch memory past the values.
+
+[[gnu::target("avx512f")]] inline __mmask8 mask8_avx512(const std::uint64_t* bitmap, std::size_t i) noexcept {
+  return static_cast<__mmask8>(bitmap[i / 64] >> (i % 64));
+}
+
+// GCC 12 writes the unmasked max/min/extract intrinsics (and the _mm512_reduce_* helpers built on them) over
+// _mm256_undefined_pd() and friends, which -Wuninitialized reports at every use. The kernels use the masked forms
+// with an explicit source instead; with an all-ones mask they compile to the same instructions.
+constexpr __mmask8 all8 = 0xFF;
+
+// half 0 (low) or 1 (high) of x
+template <int Half>
+[[gnu::target("avx512f")]] inline __m256d half_avx512(__m512d x) noexcept {
+  return _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, x, Half);
+}
+
+[[gnu::target("avx512f")]] inline double sum_some_avx512(const double* v, const std::uint64_t* bitmap,
+                                                          std::size_t n) noexcept {
+  auto acc = _mm512_setzero_pd();
+  for (std::size_t i = 0; i < n; i += 8) {
+    acc = _mm512_add_pd(acc, _mm512_maskz_loadu_pd(mask8_avx512(bitmap, i), v + i));
+  }
+  return hsum_avx2(_mm256_add_pd(half_avx512<0>(acc), half_avx512<1>(acc)));
+}
+
+template <bool Max>
+[[gnu::target("avx512f")]] inline double extreme_some_avx512(const double* v, const std::uint64_t* bitmap,
+                                                              std::size_t n) noexcept {
+  constexpr double init = Max ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+  const auto fill = _mm512_set1_pd(init);
+  auto acc = fill;
+  for (std::size_t i = 0; i < n; i += 8) {
+    const auto x = _mm512_mask_loadu_pd(fill, mask8_avx512(bitmap, i), v + i);
+    acc = Max ? _mm512_mask_max_pd(acc, all8, acc, x) : _mm512_mask_min_pd(acc, all8, acc, x);
+  }
+  const auto lo = half_avx512<0>(acc);
+  const auto hi = half_avx512<1>(acc);
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, Max ? _mm256_max_pd(lo, hi) : _mm256_min_pd(lo, hi));
+  double r = init;
+  for (double x : lanes) {
+    r = Max ? std::max(r, x) : std::min(r, x);
+  }
+  return r;
+}
+
+[[gnu::target("avx512f")]] inline void unwrap_or_avx512(const double* v, const std::uint64_t* bitmap, std::size_t n,
+                                                         double def, double* out) noexcept {
+  const auto fill = _mm512_set1_pd(def);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(out + i, _mm512_mask_loadu_pd(fill, mask8_avx512(bitmap, i), v + i));
+  }
+  if (i < n) {
+    const auto tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(out + i, tail, _mm512_mask_loadu_pd(fill, mask8_avx512(bitmap, i), v + i));
+  }
+}
+
+#endif  // NAVP_X86_SIMD
+
+}  // namespace details
+
+// the kernel set used for OptionVector<double>, detected on first call
+inline simd_level current_simd_level() noexcept {
+  static const simd_level level = details::detect_simd_level();
+  return level;
+}
+
+// number of Some elements
+template <typename T>
+std::size_t count_some(const OptionVector<T>& vec) noexcept {
+  return vec.count_some();
+}
+
+// sum of the Some elements, T() when there is none
+template <typename T>
+  requires std::is_arithmetic_v<T>
+T sum_some(const OptionVector<T>& vec) noexcept {
+#ifdef NAVP_X86_SIMD
+  if constexpr (std::is_same_v<T, double>) {
+    switch (current_simd_level()) {
+      case simd_level::avx512:
+        return details::sum_some_avx512(vec.values(), vec.bitmap(), vec.size());
+      case simd_level::avx2:
+        return details::sum_some_avx2(vec.values(), vec.bitmap(), vec.size());
+      case simd_level::scalar:
+        break;
+    }
+  }
+#endif
+  return details::sum_some_scalar(vec.values(), vec.bitmap(), vec.size());
+}
+
+// mean of the Some elements, None when there is none. Integers are summed exactly, in 64 bits, or 128 bits for
+// 8-byte integers; other types in double.
+template <typename T>
+  requires std::is_arithmetic_v<T>
+Option<double> mean_some(const OptionVector<T>& vec) noexcept {
+  const auto n = vec.count_some();
+  if (n == 0) {
+    return None;
+  }
+  using acc_t = details::mean_acc_t<T>;
+  acc_t sum;
+  if constexpr (std::is_same_v<acc_t, T>) {
+    sum = sum_some(vec);
+  } else {
+    sum = details::sum_some_scalar<T, acc_t>(vec.values(), vec.bitmap(), vec.size());
+  }
+  return Some(static_cast<double>(sum) / static_cast<double>(n));
+}
+
+// smallest Some element, None when there is none. The result is unspecified if a Some element is NaN.
+template <typename T>
+  requires std::is_arithmetic_v<T>
+Option<T> min_some(const OptionVector<T>& vec) noexcept {
+  if (vec.count_some() == 0) {
+    return None;
+  }
+#ifdef NAVP_X86_SIMD
+  if constexpr (std::is_same_v<T, double>) {
+    switch (current_simd_level()) {
+      case simd_level::avx512:
+        return Some(details::extreme_some_avx512<false>(vec.values(), vec.bitmap(), vec.size()));
+      case simd_level::avx2:
+        return Some(details::extreme_some_avx2<false>(vec.values(), vec.bitmap(), vec.size()));
+      case simd_level::scalar:
+        break;
+    }
+  }
+#endif
+  return Some(details::extreme_some_scalar(vec.values(), vec.bitmap(), vec.size(), details::extreme_init<T, false>(),
+                                           std::less<T>{}));
+}
+
+// largest Some element, None when there is none. The result is unspecified if a Some element is NaN.
+template <typename T>
+  requires std::is_arithmetic_v<T>
+Option<T> max_some(const OptionVector<T>& vec) noexcept {
+  if (vec.count_some() == 0) {
+    return None;
+  }
+#ifdef NAVP_X86_SIMD
+  if constexpr (std::is_same_v<T, double>) {
+    switch (current_simd_level()) {
+      case simd_level::avx512:
+        return Some(details::extreme_some_avx512<true>(vec.values(), vec.bitmap(), vec.size()));
+      case simd_level::avx2:
+        return Some(details::extreme_some_avx2<true>(vec.values(), vec.bitmap(), vec.size()));
+      case simd_level::scalar:
+        break;
+    }
+  }
+#endif
+  return Some(details::extreme_some_scalar(vec.values(), vec.bitmap(), vec.size(), details::extreme_init<T, true>(),
+                                           std::greater<T>{}));
+}
+
+// batch Option::unwrap_or: the Some values, with `def` in place of every None
+template <typename T>
+std::vector<T> unwrap_or(const OptionVector<T>& vec, const T& def) {
+  std::vector<T> out(vec.size());
+#ifdef NAVP_X86_SIMD
+  if constexpr (std::is_same_v<T, double>) {
+    switch (current_simd_level()) {
+      case simd_level::avx512:
+        details::unwrap_or_avx512(vec.values(), vec.bitmap(), vec.size(), def, out.data());
+        return out;
+      case simd_level::avx2:
+        details::unwrap_or_avx2(vec.values(), vec.bitmap(), vec.size(), def, out.data());
+        return out;
+      case simd_level::scalar:
+        break;
+    }
+  }
+#endif
+  details::unwrap_or_scalar(vec.values(), vec.bitmap(), vec.size(), def, out.data());
+  return out;
+}
+
+// batch Option::map: f is applied to the Some elements only, as Option::map does. Full bitmap words are mapped
+// without a test per element, so the loop vectorizes for simple f on dense data. The result has the same bitmap,
+// and its None slots hold value-initialized U.
+template <typename T, typename F, typename U = std::remove_cvref_t<std::invoke_result_t<F&, const T&>>>
+OptionVector<U> map(const OptionVector<T>& vec, F&& f) {
+  OptionVector<U> out(vec.size());
+  const T* v = vec.values();
+  U* o = out.values();
+  const auto* bitmap = vec.bitmap();
+  for (std::size_t k = 0; k < vec.bitmap_words(); ++k) {
+    if (const auto w = bitmap[k]; w == ~std::uint64_t{0}) {
+      for (std::size_t i = k * 64; i < k * 64 + 64; ++i) {
+        o[i] = f(v[i]);
+      }
+    } else {
+      for (auto m = w; m != 0; m &= m - 1) {
+        const auto i = k * 64 + static_cast<std::size_t>(std::countr_zero(m));
+        o[i] = f(v[i]);
+      }
+    }
+  }
+  std::copy_n(bitmap, vec.bitmap_words(), out.bitmap());
+  return out;
+}
+
+}  // namespace navp
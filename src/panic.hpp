@@ -0,0 +1,276 @@
+#pragma once
+
+#include <atomic>
+#include <cpptrace/cpptrace.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <source_location>
+#include <stdexcept>
+
+// Failure path shared by Option and Result.
+//
+// NAVP_PANIC_POLICY selects what a failed unwrap()/expect() does:
+//   NAVP_PANIC_THROW    throw option_error/result_error (default when exceptions are enabled)
+//   NAVP_PANIC_ABORT    print the message and call std::abort() (default under -fno-exceptions)
+//   NAVP_PANIC_TRAP     execute a trap instruction, nothing is printed
+//   NAVP_PANIC_HANDLER  call the handler installed by navp::set_panic_handler(), then abort if it returns
+//
+// Every failure records the std::source_location of the unwrap()/expect() call in the error. Stack traces are
+// opt-in, with NAVP_PANIC_THROW:
+//   NAVP_EAGER_TRACE  print a symbolized stack trace with source snippets before throwing, once per call site:
+//                     later failures at the same site only print a one-line count when it reaches a power of two.
+//                     Define NAVP_NO_TRACE_DEDUP as well to print the full trace on every failure. Up to
+//                     NAVP_PANIC_SITE_CAPACITY call sites are tracked (default 256); failures at any further site
+//                     print no trace, only a one-line count of all such failures when it reaches a power of two.
+//   NAVP_LAZY_TRACE   only capture the raw frame addresses into the thrown error; they are symbolized when
+//                     traced_error::trace() or traced_error::print_trace() is called.
+
+#define NAVP_PANIC_THROW 0
+#define NAVP_PANIC_ABORT 1
+#define NAVP_PANIC_TRAP 2
+#define NAVP_PANIC_HANDLER 3
+
+#ifndef NAVP_PANIC_POLICY
+#if defined(__cpp_exceptions)
+#define NAVP_PANIC_POLICY NAVP_PANIC_THROW
+#else
+#define NAVP_PANIC_POLICY NAVP_PANIC_ABORT
+#endif
+#endif
+
+#if NAVP_PANIC_POLICY == NAVP_PANIC_THROW && !defined(__cpp_exceptions)
+#error "NAVP_PANIC_THROW requires exceptions"
+#endif
+
+#if defined(NAVP_EAGER_TRACE) && defined(NAVP_LAZY_TRACE)
+#error "NAVP_EAGER_TRACE and NAVP_LAZY_TRACE are exclusive"
+#endif
+
+#ifndef NAVP_PANIC_SITE_CAPACITY
+#define NAVP_PANIC_SITE_CAPACITY 256
+#endif
+
+namespace navp {
+
+namespace details {
+
+// the message of a failed expect()
+// A string literal (any constant char array) is kept by pointer. Any other string, passed as a pointer, is copied
+// by the error, so it may be a temporary such as `s.c_str()`. A char array that is not constant must be passed as a
+// pointer (`+buf`) to be copied, it does not compile otherwise.
+class panic_message {
+ public:
+  template <std::size_t N>
+  consteval panic_message(const char (&msg)[N]) noexcept : _m_msg(msg), _m_literal(true) {}
+  template <typename P>
+    requires std::same_as<P, const char*> || std::same_as<P, char*>
+  constexpr panic_message(P msg) noexcept : _m_msg(msg), _m_literal(false) {}
+
+  constexpr const char* c_str() const noexcept { return _m_msg; }
+  // whether the text has static storage duration
+  constexpr bool is_literal() const noexcept { return _m_literal; }
+
+ private:
+  const char* _m_msg;
+  bool _m_literal;
+};
+
+}  // namespace details
+
+// base of option_error and result_error
+//
+// A literal message is kept by pointer and the std::runtime_error base is built from an empty string, which
+// libstdc++ shares without allocating: a failed expect("...") then allocates nothing besides the exception object
+// itself, which the runtime can take from its emergency pool when the heap is exhausted. Other messages are copied.
+class traced_error : public std::runtime_error {
+ public:
+  explicit traced_error(const char* msg, std::source_location loc = {}) : std::runtime_error(msg), _m_loc(loc) {}
+  traced_error(const char* msg, std::source_location loc, cpptrace::raw_trace&& trace)
+      : std::runtime_error(msg), _m_loc(loc), _m_raw(std::move(trace)) {}
+  traced_error(details::panic_message msg, std::source_location loc)
+      : std::runtime_error(msg.is_literal() ? "" : msg.c_str()),
+        _m_literal(msg.is_literal() ? msg.c_str() : nullptr),
+        _m_loc(loc) {}
+  traced_error(details::panic_message msg, std::source_location loc, cpptrace::raw_trace&& trace)
+      : traced_error(msg, loc) {
+    _m_raw = std::move(trace);
+  }
+
+  const char* what() const noexcept override { return _m_literal != nullptr ? _m_literal : std::runtime_error::what(); }
+
+  // where the failing unwrap()/expect() was called
+  const std::source_location& location() const noexcept { return _m_loc; }
+
+  // frame addresses captured at the failure, empty unless NAVP_LAZY_TRACE is defined
+  const cpptrace::raw_trace& raw_trace() const noexcept { return _m_raw; }
+
+  // symbolized stack trace, resolved on first call (not synchronized)
+  const cpptrace::stacktrace& trace() const {
+    if (!_m_resolved) {
+      _m_resolved = std::make_shared<const cpptrace::stacktrace>(_m_raw.resolve());
+    }
+    return *_m_resolved;
+  }
+
+  void print_trace() const { trace().print_with_snippets(); }
+
+ private:
+  const char* _m_literal = nullptr;
+  std::source_location _m_loc;
+  cpptrace::raw_trace _m_raw;
+  mutable std::shared_ptr<const cpptrace::stacktrace> _m_resolved;
+};
+
+// called on failure under NAVP_PANIC_HANDLER with the unwrap/expect message and its call site
+using panic_handler_t = void (*)(const char* msg, const std::source_location& loc);
+
+namespace details {
+
+inline std::atomic<panic_handler_t> g_panic_handler{nullptr};
+
+// lock-free failure counters keyed by call site, the file name pointer and line of the unwrap()/expect() call
+// (open addressing, entries are never removed)
+class panic_site_table {
+ public:
+  static constexpr std::size_t capacity = NAVP_PANIC_SITE_CAPACITY;
+  static_assert(capacity > 0, "NAVP_PANIC_SITE_CAPACITY must be positive");
+
+  // count a failure at `loc` and return the new count, 0 when the table is full
+  std::uint64_t hit(const std::source_location& loc) noexcept {
+    const char* file = loc.file_name();
+    const auto line = static_cast<std::uint32_t>(loc.line());
+    const auto key = reinterpret_cast<std::uintptr_t>(file) ^ (std::uintptr_t{line} << 1);
+    const auto hash = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+    for (std::size_t i = 0; i < capacity; ++i) {
+      auto& slot = _m_slots[(hash + i) % capacity];
+      auto state = slot.state.load(std::memory_order_acquire);
+      if (state == empty && slot.state.compare_exchange_strong(state, claiming, std::memory_order_acquire)) {
+        slot.file = file;
+        slot.line = line;
+        slot.state.store(published, std::memory_order_release);
+        return slot.count.fetch_add(1, std::memory_order_relaxed) + 1;
+      }
+      // another failure is publishing its key in this slot, which takes a few instructions
+      while (state == claiming) {
+        state = slot.state.load(std::memory_order_acquire);
+      }
+      if (slot.file == file && slot.line == line) {
+        return slot.count.fetch_add(1, std::memory_order_relaxed) + 1;
+      }
+    }
+    return 0;
+  }
+
+  // count a failure at a site that did not fit in the table and return the count of all such failures
+  std::uint64_t hit_untracked() noexcept { return _m_untracked.fetch_add(1, std::memory_order_relaxed) + 1; }
+  std::uint64_t untracked() const noexcept { return _m_untracked.load(std::memory_order_relaxed); }
+
+  template <typename F>
+  void for_each(F&& f) const {
+    for (const auto& slot : _m_slots) {
+      if (slot.state.load(std::memory_order_acquire) == published) {
+        f(slot.file, slot.line, slot.count.load(std::memory_order_relaxed));
+      }
+    }
+  }
+
+ private:
+  static constexpr std::uint32_t empty = 0;
+  static constexpr std::uint32_t claiming = 1;
+  static constexpr std::uint32_t published = 2;
+
+  struct slot {
+    std::atomic<std::uint32_t> state{empty};
+    // written once by the claiming thread before `state` becomes published
+    std::uint32_t line = 0;
+    const char* file = nullptr;
+    std::atomic<std::uint64_t> count{0};
+  };
+  slot _m_slots[capacity];
+  std::atomic<std::uint64_t> _m_untracked{0};
+};
+
+inline panic_site_table g_panic_sites;
+
+// whether the full trace should be printed for this failure
+inline bool should_print_trace(const char* msg, const std::source_location& loc) noexcept {
+#ifdef NAVP_NO_TRACE_DEDUP
+  (void)msg;
+  (void)loc;
+  return true;
+#else
+  const auto n = g_panic_sites.hit(loc);
+  if (n == 0) [[unlikely]] {
+    // the table is full, the remaining sites share one counter and never print a trace
+    const auto untracked = g_panic_sites.hit_untracked();
+    if ((untracked & (untracked - 1)) == 0) {
+      std::fprintf(stderr, "navp panic: %s at %s:%u (%llu failures at untracked call sites)\n", msg, loc.file_name(),
+                   static_cast<unsigned>(loc.line()), static_cast<unsigned long long>(untracked));
+    }
+    return false;
+  }
+  if (n > 1 && (n & (n - 1)) == 0) {
+    std::fprintf(stderr, "navp panic: %s at %s:%u (%llu failures)\n", msg, loc.file_name(),
+                 static_cast<unsigned>(loc.line()), static_cast<unsigned long long>(n));
+  }
+  return n <= 1;
+#endif
+}
+
+}  // namespace details
+
+// call f(const char* file, std::uint32_t line, std::uint64_t failures) for every call site that has failed so far
+template <typename F>
+void for_each_panic_site(F&& f) {
+  details::g_panic_sites.for_each(std::forward<F>(f));
+}
+
+// number of failures at call sites past the first NAVP_PANIC_SITE_CAPACITY, which for_each_panic_site() does not list
+inline std::uint64_t untracked_panic_failures() noexcept { return details::g_panic_sites.untracked(); }
+
+// install `handler` and return the previous one
+inline panic_handler_t set_panic_handler(panic_handler_t handler) noexcept {
+  return details::g_panic_handler.exchange(handler, std::memory_order_acq_rel);
+}
+
+namespace details {
+
+// `loc` is where the failing unwrap()/expect() was called
+template <typename Error>
+[[noreturn, gnu::cold, gnu::noinline]] void panic(panic_message msg, std::source_location loc) {
+#if NAVP_PANIC_POLICY == NAVP_PANIC_THROW
+#if defined(NAVP_LAZY_TRACE)
+  throw Error(msg, loc, cpptrace::generate_raw_trace(1));
+#elif defined(NAVP_EAGER_TRACE)
+  if (should_print_trace(msg.c_str(), loc)) {
+    cpptrace::generate_trace(1).print_with_snippets();
+  }
+  throw Error(msg, loc);
+#else
+  throw Error(msg, loc);
+#endif
+#elif NAVP_PANIC_POLICY == NAVP_PANIC_ABORT
+  std::fprintf(stderr, "navp panic: %s at %s:%u in %s\n", msg.c_str(), loc.file_name(),
+               static_cast<unsigned>(loc.line()), loc.function_name());
+  std::abort();
+#elif NAVP_PANIC_POLICY == NAVP_PANIC_TRAP
+  (void)msg;
+  (void)loc;
+  __builtin_trap();
+#elif NAVP_PANIC_POLICY == NAVP_PANIC_HANDLER
+  if (auto handler = g_panic_handler.load(std::memory_order_acquire)) {
+    handler(msg.c_str(), loc);
+  }
+  std::abort();
+#else
+#error "unknown NAVP_PANIC_POLICY"
+#endif
+}
+
+}  // namespace details
+
+}  // namespace navp
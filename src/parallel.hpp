@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "template_utils.hpp"
+
+// Parallel map over a random access range with a fallible function.
+//
+//   par_map(range, f) with f(elem) -> Result<U, E>   gives Result<std::vector<U>, E>
+//   par_map(range, f) with f(elem) -> Option<U>      gives Option<std::vector<U>>
+//
+// The range is cut into chunks that worker threads take in index order. Once an element fails, no chunk after it
+// is started and running chunks stop at it, but every element before it is still evaluated, so the error returned
+// is always the one with the smallest index, as in a sequential loop. An exception thrown by f counts as a failure
+// at its element: it cancels the work after it and is rethrown on the calling thread, unless an earlier element
+// failed or threw first.
+
+namespace navp {
+
+struct parallel_options {
+  // worker threads including the caller, 0 for std::thread::hardware_concurrency()
+  unsigned threads = 0;
+  // elements per chunk, 0 to aim for about 8 chunks per thread
+  std::size_t chunk = 0;
+};
+
+namespace details {
+
+// what f returns for an element of R
+template <typename F, typename R>
+using par_result_t = std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<R>>>;
+
+// the smallest failing index seen so far, workers skip everything past it
+class first_failure {
+ public:
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  std::size_t get() const noexcept { return _m_index.load(std::memory_order_acquire); }
+
+  // lower the failing index to i, true if i is now the smallest
+  bool lower(std::size_t i) noexcept {
+    auto cur = _m_index.load(std::memory_order_relaxed);
+    while (i < cur) {
+      if (_m_index.compare_exchange_weak(cur, i, std::memory_order_acq_rel)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::atomic<std::size_t> _m_index{none};
+};
+
+// run body(begin, end) over [0, n) in chunks on `opts.threads` threads, skipping chunks past `failure`
+template <typename Body>
+void par_chunks(std::size_t n, parallel_options opts, first_failure& failure, Body& body) {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned threads = opts.threads == 0 ? hw : opts.threads;
+  const std::size_t chunk = opts.chunk != 0 ? opts.chunk : std::max<std::size_t>(1, n / (std::size_t{threads} * 8));
+  const std::size_t chunks = (n + chunk - 1) / chunk;
+
+  std::atomic<std::size_t> next{0};
+#if defined(__cpp_exceptions)
+  // the exception of the earliest chunk that threw, a chunk stops at its first throw so this is the earliest element
+  std::exception_ptr exception;
+  std::size_t exception_chunk = first_failure::none;
+  std::mutex exception_mutex;
+#endif
+
+  auto worker = [&] {
+    for (;;) {
+      const auto c = next.fetch_add(1, std::memory_order_relaxed);
+      if (c >= chunks || c * chunk > failure.get()) {
+        return;
+      }
+#if defined(__cpp_exceptions)
+      try {
+        body(c * chunk, std::min(n, (c + 1) * chunk));
+      } catch (...) {
+        failure.lower(c * chunk);
+        std::lock_guard lock(exception_mutex);
+        if (c < exception_chunk) {
+          exception = std::current_exception();
+          exception_chunk = c;
+        }
+        return;
+      }
+#else
+      body(c * chunk, std::min(n, (c + 1) * chunk));
+#endif
+    }
+  };
+
+  std::vector<std::jthread> pool;
+  const auto spawn = std::min<std::size_t>(threads, chunks);
+  pool.reserve(spawn > 0 ? spawn - 1 : 0);
+  for (std::size_t t = 1; t < spawn; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  pool.clear();
+
+#if defined(__cpp_exceptions)
+  // a failure lowered below the chunk is an earlier element, it wins like in a sequential loop
+  if (exception && exception_chunk * chunk <= failure.get()) {
+    std::rethrow_exception(exception);
+  }
+#endif
+}
+
+}  // namespace details
+
+template <std::ranges::random_access_range R, typename F>
+  requires std::ranges::sized_range<R> && details::is_instance_of<details::par_result_t<F, R>, Result>::value
+auto par_map(R&& range, F&& f, parallel_options opts = {}) {
+  using result_t = details::par_result_t<F, R>;
+  using U = typename result_t::ok_type;
+  using E = typename result_t::err_type;
+  static_assert(std::is_default_constructible_v<U> && std::is_move_assignable_v<U>,
+                "par_map fills a std::vector<U> in place, U must be default constructible and move assignable");
+
+  const auto n = static_cast<std::size_t>(std::ranges::size(range));
+  const auto first = std::ranges::begin(range);
+  std::vector<U> out(n);
+  details::first_failure failure;
+  Option<E> error;
+  std::mutex error_mutex;
+
+  auto body = [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end && i <= failure.get(); ++i) {
+      auto r = f(first[static_cast<std::ranges::range_difference_t<R>>(i)]);
+      if (r.is_ok()) [[likely]] {
+        out[i] = std::move(r).unwrap_unchecked();
+      } else {
+        std::lock_guard lock(error_mutex);
+        if (failure.lower(i)) {
+          error = std::move(r).unwrap_err_unchecked();
+        }
+        return;
+      }
+    }
+  };
+  details::par_chunks(n, opts, failure, body);
+
+  if (failure.get() != details::first_failure::none) {
+    return Result<std::vector<U>, E>(Err<E>(std::move(error).unwrap_unchecked()));
+  }
+  return Result<std::vector<U>, E>(Ok<std::vector<U>>(std::move(out)));
+}
+
+template <std::ranges::random_access_range R, typename F>
+  requires std::ranges::sized_range<R> && details::is_instance_of<details::par_result_t<F, R>, Option>::value
+auto par_map(R&& range, F&& f, parallel_options opts = {}) {
+  using U = typename details::par_result_t<F, R>::value_type;
+  static_assert(std::is_default_constructible_v<U> && std::is_move_assignable_v<U>,
+                "par_map fills a std::vector<U> in place, U must be default constructible and move assignable");
+
+  const auto n = static_cast<std::size_t>(std::ranges::size(range));
+  const auto first = std::ranges::begin(range);
+  std::vector<U> out(n);
+  details::first_failure failure;
+
+  auto body = [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end && i <= failure.get(); ++i) {
+      auto op = f(first[static_cast<std::ranges::range_difference_t<R>>(i)]);
+      if (op.is_some()) [[likely]] {
+        out[i] = std::move(op).unwrap_unchecked();
+      } else {
+        failure.lower(i);
+        return;
+      }
+    }
+  };
+  details::par_chunks(n, opts, failure, body);
+
+  if (failure.get() != details::first_failure::none) {
+    return Option<std::vector<U>>(None);
+  }
+  return Some(std::move(out));
+}
+
+}  // namespace navp
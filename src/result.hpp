@@ -1,16 +1,32 @@
 #pragma once
 
-#include <cpptrace/cpptrace.hpp>
+#include <memory>
 #include <variant>
 
+#include "panic.hpp"
 #include "template_utils.hpp"
 
 namespace navp {
 
-class result_error : public std::runtime_error {
-  using std::runtime_error::runtime_error;
+class result_error : public traced_error {
+  using traced_error::traced_error;
 };
 
+namespace details {
+
+// out-of-line failure paths, keeps unwrap()/expect() down to a test and a load at the call site
+[[noreturn, gnu::cold, gnu::noinline]] inline void panic_unwrap_err(std::source_location loc) {
+  panic<result_error>("unwrap a result with err value!", loc);
+}
+[[noreturn, gnu::cold, gnu::noinline]] inline void panic_unwrap_err_on_ok(std::source_location loc) {
+  panic<result_error>("unwrap_err a result with ok value!", loc);
+}
+[[noreturn, gnu::cold, gnu::noinline]] inline void panic_expect(panic_message msg, std::source_location loc) {
+  panic<result_error>(msg, loc);
+}
+
+}  // namespace details
+
 template <typename T>
 class Option;
 
@@ -25,6 +41,9 @@ struct Err;
 
 namespace details {
 
+template <typename... Args>
+struct context_fmt;
+
 struct ok_tag_t {};
 struct err_tag_t {};
 
@@ -127,14 +146,220 @@ struct Err : public details::result_construct_assgin_base<E, details::err_tag_t>
   using details::result_construct_assgin_base<E, details::err_tag_t>::result_construct_assgin_base;
 };
 
+// Ok<void> and Err<void> carry no value, e.g. `Result<void, E> r = Ok();`
+template <>
+struct Ok<void> {};
+template <>
+struct Err<void> {};
+
+namespace details {
+
+// reference types of the ok/err value, void for Result<void, E> and Result<T, void>
+template <typename T>
+using ref_t = std::add_lvalue_reference_t<T>;
+template <typename T>
+using rref_t = std::add_rvalue_reference_t<T>;
+template <typename T>
+using cref_t = std::conditional_t<std::is_void_v<T>, void, std::add_lvalue_reference_t<const T>>;
+template <typename T>
+using crref_t = std::conditional_t<std::is_void_v<T>, void, std::add_rvalue_reference_t<const T>>;
+
+// tagged union used as the storage of Result
+template <typename T, typename E>
+class result_storage {
+ protected:
+  using ok_t = Ok<T>;
+  using err_t = Err<E>;
+
+  static constexpr bool _s_trivially_copy_constructible =
+      std::is_trivially_copy_constructible_v<ok_t> && std::is_trivially_copy_constructible_v<err_t>;
+  static constexpr bool _s_trivially_move_constructible =
+      std::is_trivially_move_constructible_v<ok_t> && std::is_trivially_move_constructible_v<err_t>;
+  static constexpr bool _s_trivially_destructible =
+      std::is_trivially_destructible_v<ok_t> && std::is_trivially_destructible_v<err_t>;
+  static constexpr bool _s_trivially_copy_assignable = _s_trivially_copy_constructible && _s_trivially_destructible &&
+                                                       std::is_trivially_copy_assignable_v<ok_t> &&
+                                                       std::is_trivially_copy_assignable_v<err_t>;
+  static constexpr bool _s_trivially_move_assignable = _s_trivially_move_constructible && _s_trivially_destructible &&
+                                                       std::is_trivially_move_assignable_v<ok_t> &&
+                                                       std::is_trivially_move_assignable_v<err_t>;
+
+ public:
+  template <typename... Args>
+  explicit constexpr result_storage(ok_tag_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<ok_t, Args...>)
+      : _m_ok(std::forward<Args>(args)...), _m_is_ok(true) {}
+
+  template <typename... Args>
+  explicit constexpr result_storage(err_tag_t, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<err_t, Args...>)
+      : _m_err(std::forward<Args>(args)...), _m_is_ok(false) {}
+
+  result_storage(const result_storage&)
+    requires _s_trivially_copy_constructible
+  = default;
+
+  constexpr result_storage(const result_storage& other) noexcept(
+      std::is_nothrow_copy_constructible_v<ok_t> && std::is_nothrow_copy_constructible_v<err_t>)
+    requires std::is_copy_constructible_v<ok_t> && std::is_copy_constructible_v<err_t> &&
+             (!_s_trivially_copy_constructible)
+      : _m_is_ok(other._m_is_ok) {
+    if (_m_is_ok) {
+      std::construct_at(std::addressof(_m_ok), other._m_ok);
+    } else {
+      std::construct_at(std::addressof(_m_err), other._m_err);
+    }
+  }
+
+  result_storage(result_storage&&)
+    requires _s_trivially_move_constructible
+  = default;
+
+  constexpr result_storage(result_storage&& other) noexcept(
+      std::is_nothrow_move_constructible_v<ok_t> && std::is_nothrow_move_constructible_v<err_t>)
+    requires std::is_move_constructible_v<ok_t> && std::is_move_constructible_v<err_t> &&
+             (!_s_trivially_move_constructible)
+      : _m_is_ok(other._m_is_ok) {
+    if (_m_is_ok) {
+      std::construct_at(std::addressof(_m_ok), std::move(other._m_ok));
+    } else {
+      std::construct_at(std::addressof(_m_err), std::move(other._m_err));
+    }
+  }
+
+  result_storage& operator=(const result_storage&)
+    requires _s_trivially_copy_assignable
+  = default;
+
+  // one of ok_t and err_t must be nothrow move constructible, so that a failed assignment can be rolled back
+  constexpr result_storage& operator=(const result_storage& other) noexcept(
+      std::is_nothrow_copy_constructible_v<ok_t> && std::is_nothrow_copy_constructible_v<err_t> &&
+      std::is_nothrow_copy_assignable_v<ok_t> && std::is_nothrow_copy_assignable_v<err_t>)
+    requires std::is_copy_assignable_v<ok_t> && std::is_copy_constructible_v<ok_t> &&
+             std::is_copy_assignable_v<err_t> && std::is_copy_constructible_v<err_t> &&
+             (std::is_nothrow_move_constructible_v<ok_t> || std::is_nothrow_move_constructible_v<err_t>) &&
+             (!_s_trivially_copy_assignable)
+  {
+    _m_assign(other);
+    return *this;
+  }
+
+  result_storage& operator=(result_storage&&)
+    requires _s_trivially_move_assignable
+  = default;
+
+  constexpr result_storage& operator=(result_storage&& other) noexcept(
+      std::is_nothrow_move_constructible_v<ok_t> && std::is_nothrow_move_constructible_v<err_t> &&
+      std::is_nothrow_move_assignable_v<ok_t> && std::is_nothrow_move_assignable_v<err_t>)
+    requires std::is_move_assignable_v<ok_t> && std::is_move_constructible_v<ok_t> &&
+             std::is_move_assignable_v<err_t> && std::is_move_constructible_v<err_t> &&
+             (std::is_nothrow_move_constructible_v<ok_t> || std::is_nothrow_move_constructible_v<err_t>) &&
+             (!_s_trivially_move_assignable)
+  {
+    _m_assign(std::move(other));
+    return *this;
+  }
+
+  ~result_storage()
+    requires _s_trivially_destructible
+  = default;
+
+  constexpr ~result_storage() { _m_destroy(); }
+
+ protected:
+  constexpr void _m_destroy() noexcept {
+    if (_m_is_ok) {
+      std::destroy_at(std::addressof(_m_ok));
+    } else {
+      std::destroy_at(std::addressof(_m_err));
+    }
+  }
+
+  // switch the active member to `New`, keeping the old one alive until the new one is constructed
+  // when that can throw (the same strategy as std::expected)
+  template <typename New, typename Old, typename... Args>
+  static constexpr void _s_reinit(New* new_val, Old* old_val, Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<New, Args...>) {
+      std::destroy_at(old_val);
+      std::construct_at(new_val, std::forward<Args>(args)...);
+    } else if constexpr (std::is_nothrow_move_constructible_v<New>) {
+      New tmp(std::forward<Args>(args)...);
+      std::destroy_at(old_val);
+      std::construct_at(new_val, std::move(tmp));
+    } else {
+      static_assert(std::is_nothrow_move_constructible_v<Old>,
+                    "either the ok or the err type must be nothrow move constructible");
+      Old tmp(std::move(*old_val));
+      std::destroy_at(old_val);
+#if defined(__cpp_exceptions)
+      try {
+        std::construct_at(new_val, std::forward<Args>(args)...);
+      } catch (...) {
+        std::construct_at(old_val, std::move(tmp));
+        throw;
+      }
+#else
+      std::construct_at(new_val, std::forward<Args>(args)...);
+#endif
+    }
+  }
+
+  // assign a value, in place when it is the active alternative (like std::expected), so that a throwing assignment
+  // leaves the old value alive
+  template <typename U>
+  constexpr void _m_assign_ok(U&& val) {
+    if (_m_is_ok) {
+      _m_ok = std::forward<U>(val);
+    } else {
+      _s_reinit(std::addressof(_m_ok), std::addressof(_m_err), std::forward<U>(val));
+      _m_is_ok = true;
+    }
+  }
+
+  template <typename G>
+  constexpr void _m_assign_err(G&& val) {
+    if (!_m_is_ok) {
+      _m_err = std::forward<G>(val);
+    } else {
+      _s_reinit(std::addressof(_m_err), std::addressof(_m_ok), std::forward<G>(val));
+      _m_is_ok = false;
+    }
+  }
+
+  // assign from another storage, `Other` is result_storage const& or result_storage&&
+  template <typename Other>
+  constexpr void _m_assign(Other&& other) {
+    if (_m_is_ok && other._m_is_ok) {
+      _m_ok = std::forward<Other>(other)._m_ok;
+    } else if (!_m_is_ok && !other._m_is_ok) {
+      _m_err = std::forward<Other>(other)._m_err;
+    } else if (other._m_is_ok) {
+      _s_reinit(std::addressof(_m_ok), std::addressof(_m_err), std::forward<Other>(other)._m_ok);
+      _m_is_ok = true;
+    } else {
+      _s_reinit(std::addressof(_m_err), std::addressof(_m_ok), std::forward<Other>(other)._m_err);
+      _m_is_ok = false;
+    }
+  }
+
+  union {
+    ok_t _m_ok;
+    err_t _m_err;
+  };
+  bool _m_is_ok;
+};
+
+}  // namespace details
+
 // decuce helper
 template <typename T>
 Ok(T) -> Ok<T>;
 template <typename E>
 Err(E) -> Err<E>;
+Ok() -> Ok<void>;
+Err() -> Err<void>;
 
 template <typename T, typename E>
-class Result : private std::variant<Ok<T>, Err<E>> {
+class Result : private details::result_storage<T, E> {
  private:
   template <typename _Up>
   using __not_self = std::__not_<std::is_same<Result, std::__remove_cvref_t<_Up>>>;
@@ -151,108 +376,55 @@ class Result : private std::variant<Ok<T>, Err<E>> {
   template <typename U>
   using not_variant = _not<details::is_instance_of<rmcv_ref_t<U>, std::variant>>;
 
-  using _Base = std::variant<Ok<T>, Err<E>>;
+  using _Base = details::result_storage<T, E>;
   using ok_t = Ok<T>;
   using err_t = Err<E>;
 
  public:
+  using ok_type = T;
+  using err_type = E;
+
   // default constructor(default Ok)
   // only when U can default construct
-  constexpr Result() noexcept(std::is_nothrow_default_constructible_v<T>)
-    requires std::is_default_constructible_v<T>
-      : _Base(T()) {}
+  constexpr Result() noexcept(std::is_nothrow_default_constructible_v<ok_t>)
+    requires std::is_default_constructible_v<ok_t>
+      : _Base(details::ok_tag_t{}) {}
 
   Result(const Result&) = default;
-
-  // when T or E is not trivially copy constructible, overload default copy constructor
-  constexpr Result(const Result& _other) noexcept(
-      _and<std::is_nothrow_copy_constructible<T>, std::is_nothrow_copy_constructible<E>>::value)
-    requires std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E> &&
-             (!std::is_trivially_copy_constructible_v<T> || !std::is_trivially_copy_constructible_v<E>)
-  {
-    if (_other.is_ok()) {
-      this->template emplace<0>(_other._m_get_ok_value());
-    } else {
-      this->template emplace<1>(_other._m_get_err_value());
-    }
-  }
-
   Result(Result&&) = default;
 
-  // when T or E is not trivially move constructible, overload default move constructor
-  constexpr Result(Result&& _other) noexcept(
-      _and<std::is_nothrow_move_constructible<T>, std::is_nothrow_move_constructible<E>>::value)
-    requires std::is_move_constructible_v<T> && std::is_move_constructible_v<E> &&
-             (!std::is_trivially_move_constructible_v<T> || !std::is_trivially_move_constructible_v<E>)
-  {
-    if (_other.is_ok()) {
-      this->template emplace<0>(std::move(_other._m_get_ok_value()));
-    } else {
-      this->template emplace<1>(std::move(_other._m_get_err_value()));
-    }
-  }
-
-  Result& operator=(const Result&) = delete;
-
-  // when T or E can be move nothrowable, overload copy assign
-  constexpr Result& operator=(const Result& _other) noexcept(
-      _and<std::is_nothrow_copy_constructible<T>, std::is_nothrow_copy_constructible<E>,
-           std::is_nothrow_copy_assignable<T>, std::is_nothrow_copy_assignable<E>>::value)
-    requires std::is_copy_assignable_v<T> && std::is_copy_constructible_v<T> && std::is_copy_assignable_v<E> &&
-             std::is_copy_constructible_v<E> &&
-             (std::is_nothrow_move_constructible_v<T> || std::is_nothrow_move_constructible_v<E>)
-  {
-    if (_other.is_ok()) {
-      this->template emplace<0>(_other._m_get_ok_value());
-    } else {
-      this->template emplace<1>(_other._m_get_err_value());
-    }
-  }
-
+  Result& operator=(const Result&) = default;
   Result& operator=(Result&&) = default;
 
-  // when T or E can be move nothrowable, overload move assign
-  constexpr Result& operator=(Result&& _other) noexcept(
-      _and<std::is_nothrow_move_constructible<T>, std::is_nothrow_move_constructible<E>,
-           std::is_nothrow_move_assignable<T>, std::is_nothrow_move_assignable<E>>::value)
-    requires std::is_move_assignable_v<T> && std::is_move_constructible_v<T> && std::is_move_assignable_v<E> &&
-             std::is_move_constructible_v<E> &&
-             (std::is_nothrow_move_constructible_v<T> || std::is_nothrow_move_constructible_v<E>)
-  {
-    if (_other.is_ok()) {
-      this->template emplace<0>(std::move(_other._m_get_ok_value()));
-    } else {
-      this->template emplace<1>(std::move(_other._m_get_err_value()));
-    }
-  }
-
   constexpr ~Result() = default;
 
   // construct from ok_t or err_t
   template <typename U, _Requires<not_result<U>, not_variant<U>, std::is_constructible<ok_t, U>,
                                   std::is_convertible<U, ok_t>> = true>
-  constexpr Result(U&& ok_val) noexcept(std::is_nothrow_constructible_v<T, U>) : _Base(std::forward<U>(ok_val)) {}
+  constexpr Result(U&& ok_val) noexcept(std::is_nothrow_constructible_v<T, U>)
+      : _Base(details::ok_tag_t{}, std::forward<U>(ok_val)) {}
 
   template <typename U, _Requires<not_result<U>, not_variant<U>, std::is_constructible<ok_t, U>,
                                   _not<std::is_same<ok_t, err_t>>, _not<std::is_convertible<U, ok_t>>> = false>
   explicit constexpr Result(U&& ok_val) noexcept(std::is_nothrow_constructible_v<ok_t, U>)
-      : _Base(std::forward<U>(ok_val)) {}
+      : _Base(details::ok_tag_t{}, std::forward<U>(ok_val)) {}
 
   template <typename G, _Requires<not_result<G>, not_variant<G>, std::is_constructible<err_t, G>,
                                   std::is_convertible<G, err_t>> = true>
-  constexpr Result(G&& err_val) noexcept(std::is_nothrow_constructible_v<err_t, G>) : _Base(std::forward<G>(err_val)) {}
+  constexpr Result(G&& err_val) noexcept(std::is_nothrow_constructible_v<err_t, G>)
+      : _Base(details::err_tag_t{}, std::forward<G>(err_val)) {}
 
   template <typename G, _Requires<not_result<G>, not_variant<G>, std::is_constructible<err_t, G>,
                                   _not<std::is_same<ok_t, err_t>>, _not<std::is_convertible<G, err_t>>> = false>
   explicit constexpr Result(G&& err_val) noexcept(std::is_nothrow_constructible_v<err_t, G>)
-      : _Base(std::forward<G>(err_val)) {}
+      : _Base(details::err_tag_t{}, std::forward<G>(err_val)) {}
 
   // assign operator from Ok<U>,Err<G>
   template <typename U, _Requires<not_result<U>, not_variant<U>, std::is_constructible<ok_t, U>,
                                   std::is_assignable<ok_t, U>> = true>
   constexpr Result& operator=(U&& ok_val) noexcept(std::is_nothrow_constructible_v<ok_t, U> &&
                                                    std::is_nothrow_assignable_v<ok_t, U>) {
-    this->template emplace<0>((std::forward<U>(ok_val)));
+    this->_m_assign_ok(std::forward<U>(ok_val));
     return *this;
   }
 
@@ -260,14 +432,14 @@ class Result : private std::variant<Ok<T>, Err<E>> {
                                   std::is_assignable<err_t, G>> = true>
   constexpr Result& operator=(G&& ok_val) noexcept(std::is_nothrow_constructible_v<err_t, G> &&
                                                    std::is_nothrow_assignable_v<err_t, G>) {
-    this->template emplace<1>((std::forward<G>(ok_val)));
+    this->_m_assign_err(std::forward<G>(ok_val));
     return *this;
   }
 
   // is_ok
-  constexpr inline bool is_ok() const noexcept { return this->index() == 0; }
+  constexpr inline bool is_ok() const noexcept { return this->_m_is_ok; }
   // is_err
-  constexpr inline bool is_err() const noexcept { return this->index() == 1; }
+  constexpr inline bool is_err() const noexcept { return !this->_m_is_ok; }
 
   // is_ok_and
   template <typename F>
@@ -293,28 +465,28 @@ class Result : private std::variant<Ok<T>, Err<E>> {
       std::is_nothrow_copy_constructible_v<Result<U, E>>)
     requires std::is_copy_constructible_v<Result<U, E>>
   {
-    return is_ok() ? other : Result<U, E>(std::move(std::get<err_t>(*this)));
+    return is_ok() ? other : Result<U, E>(std::move(this->_m_err));
   }
   template <typename U>
   constexpr Result<U, E> operator|(const Result<U, E>& other) const& noexcept(
       std::is_nothrow_copy_constructible_v<Result<U, E>>)
     requires std::is_copy_constructible_v<Result<U, E>>
   {
-    return is_ok() ? other : Result<U, E>(std::get<err_t>(*this));
+    return is_ok() ? other : Result<U, E>(this->_m_err);
   }
   template <typename U>
   constexpr Result<U, E> operator|(Result<U, E>&& other) const&& noexcept(
       std::is_nothrow_move_constructible_v<Result<U, E>>)
     requires std::is_move_constructible_v<Result<U, E>>
   {
-    return is_ok() ? other : Result<U, E>(std::move(std::get<err_t>(*this)));
+    return is_ok() ? other : Result<U, E>(std::move(this->_m_err));
   }
   template <typename U>
   constexpr Result<U, E> operator|(Result<U, E>&& other) const& noexcept(
       std::is_nothrow_move_constructible_v<Result<U, E>>)
     requires std::is_move_constructible_v<Result<U, E>>
   {
-    return is_ok() ? other : Result<U, E>(std::get<err_t>(*this));
+    return is_ok() ? other : Result<U, E>(this->_m_err);
   }
 
   // and_then()
@@ -322,62 +494,62 @@ class Result : private std::variant<Ok<T>, Err<E>> {
   constexpr Result<U, E> and_then(F&& f) const&& noexcept(std::is_nothrow_invocable_v<F, const T&>)
     requires std::is_invocable_r_v<Result<U, E>, F, const T&>
   {
-    return is_ok() ? Result<U, E>(std::move(f(_m_get_ok_value()))) : Result<U, E>(std::move(std::get<err_t>(*this)));
+    return is_ok() ? Result<U, E>(std::move(f(_m_get_ok_value()))) : Result<U, E>(std::move(this->_m_err));
   }
   template <typename U, typename F>
   constexpr Result<U, E> and_then(F&& f) const& noexcept(std::is_nothrow_invocable_v<F, const T&>)
     requires std::is_invocable_r_v<Result<U, E>, F, const T&>
   {
-    return is_ok() ? Result<U, E>(std::move(f(_m_get_ok_value()))) : Result<U, E>(std::get<err_t>(*this));
+    return is_ok() ? Result<U, E>(std::move(f(_m_get_ok_value()))) : Result<U, E>(this->_m_err);
   }
 
   // err()
   constexpr Option<E> err() const&& noexcept(std::is_nothrow_move_constructible_v<Option<E>>)
-    requires std::is_move_constructible_v<Option<E>>
+    requires(!std::is_void_v<E>) && std::is_move_constructible_v<Option<E>>
   {
     return is_err() ? Option<E>(std::move(_m_get_err_value())) : Option<E>();
   }
 
   // ok()
   constexpr Option<T> ok() const&& noexcept(std::is_nothrow_move_constructible_v<Option<T>>)
-    requires std::is_move_constructible_v<Option<T>>
+    requires(!std::is_void_v<T>) && std::is_move_constructible_v<Option<T>>
   {
     return is_ok() ? Option<T>(std::move(_m_get_ok_value())) : Option<T>();
   }
 
-  // expect()
-  constexpr T& expect(const char* msg) const& {
-    if (is_ok()) {
-      return const_cast<T&>(_m_get_ok_value());
+  // expect(), a string literal `msg` is kept by pointer and any other string is copied
+  constexpr details::ref_t<T> expect(details::panic_message msg,
+                                    std::source_location loc = std::source_location::current()) const& {
+    if (is_ok()) [[likely]] {
+      return const_cast<Result&>(*this)._m_get_ok_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error(msg);
+      details::panic_expect(msg, loc);
     }
   }
-  constexpr T&& expect(const char* msg) const&& {
-    if (is_ok()) {
-      return std::move(_m_get_ok_value());
+  constexpr details::rref_t<T> expect(details::panic_message msg,
+                                     std::source_location loc = std::source_location::current()) const&& {
+    if (is_ok()) [[likely]] {
+      return std::move(const_cast<Result&>(*this))._m_get_ok_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error(msg);
+      details::panic_expect(msg, loc);
     }
   }
 
-  // expect_err()
-  constexpr E& expect_err(const char* msg) const& {
-    if (is_err()) {
-      return const_cast<E&>(_m_get_err_value());
+  // expect_err(), `msg` as for expect()
+  constexpr details::ref_t<E> expect_err(details::panic_message msg,
+                                        std::source_location loc = std::source_location::current()) const& {
+    if (is_err()) [[likely]] {
+      return const_cast<Result&>(*this)._m_get_err_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error(msg);
+      details::panic_expect(msg, loc);
     }
   }
-  constexpr E&& expect_err(const char* msg) const&& {
-    if (is_err()) {
-      return std::move(_m_get_err_value());
+  constexpr details::rref_t<E> expect_err(details::panic_message msg,
+                                          std::source_location loc = std::source_location::current()) const&& {
+    if (is_err()) [[likely]] {
+      return std::move(const_cast<Result&>(*this))._m_get_err_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error(msg);
+      details::panic_expect(msg, loc);
     }
   }
 
@@ -422,50 +594,50 @@ class Result : private std::variant<Ok<T>, Err<E>> {
   }
 
   // unwrap
-  constexpr T& unwrap() const& {
+  constexpr details::ref_t<T> unwrap(std::source_location loc = std::source_location::current()) const& {
     if (is_ok()) [[likely]] {
-      return const_cast<T&>(_m_get_ok_value());
+      return const_cast<Result&>(*this)._m_get_ok_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error("unwrap a result with err value!");
+      details::panic_unwrap_err(loc);
     }
   }
-  constexpr T&& unwrap() && {
+  constexpr details::rref_t<T> unwrap(std::source_location loc = std::source_location::current()) && {
     if (is_ok()) [[likely]] {
-      return std::move(_m_get_ok_value());
+      return std::move(*this)._m_get_ok_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error("unwrap a result with err value!");
+      details::panic_unwrap_err(loc);
     }
   }
 
   // unwrap_err()
-  constexpr E& unwrap_err() const& {
+  constexpr details::ref_t<E> unwrap_err(std::source_location loc = std::source_location::current()) const& {
     if (is_err()) [[likely]] {
-      return const_cast<E&>(_m_get_err_value());
+      return const_cast<Result&>(*this)._m_get_err_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error("unwrap_err a result with ok value!");
+      details::panic_unwrap_err_on_ok(loc);
     }
   }
-  constexpr E&& unwrap_err() && {
+  constexpr details::rref_t<E> unwrap_err(std::source_location loc = std::source_location::current()) && {
     if (is_err()) [[likely]] {
-      return std::move(_m_get_err_value());
+      return std::move(*this)._m_get_err_value();
     } else {
-      cpptrace::generate_trace(1).print_with_snippets();
-      throw result_error("unwrap_err a result with ok value!");
+      details::panic_unwrap_err_on_ok(loc);
     }
   }
 
   // unwrap_unchecked()
   // dangerous!!!
-  constexpr T& unwrap_unchecked() const& { return const_cast<T&>(_m_get_ok_value()); }
-  constexpr T&& unwrap_unchecked() const&& { return std::move(_m_get_ok_value()); }
+  constexpr details::ref_t<T> unwrap_unchecked() const& { return const_cast<Result&>(*this)._m_get_ok_value(); }
+  constexpr details::rref_t<T> unwrap_unchecked() const&& {
+    return std::move(const_cast<Result&>(*this))._m_get_ok_value();
+  }
 
   // unwrap_err_unchecked()
   // dangerous!!!
-  constexpr E& unwrap_err_unchecked() const& { return const_cast<E&>(_m_get_err_value()); }
-  constexpr E&& unwrap_err_unchecked() const&& { return std::move(_m_get_err_value()); }
+  constexpr details::ref_t<E> unwrap_err_unchecked() const& { return const_cast<Result&>(*this)._m_get_err_value(); }
+  constexpr details::rref_t<E> unwrap_err_unchecked() const&& {
+    return std::move(const_cast<Result&>(*this))._m_get_err_value();
+  }
 
   // unwrap_or
   template <typename U>
@@ -503,7 +675,7 @@ class Result : private std::variant<Ok<T>, Err<E>> {
   constexpr Result<U, E> map(F&& f) noexcept(std::is_nothrow_invocable_v<F, const T&>)
     requires std::is_invocable_r_v<U, F, const T&>
   {
-    return is_ok() ? Result<U, E>(f(_m_get_ok_value())) : Result<U, E>(std::get<err_t>(*this));
+    return is_ok() ? Result<U, E>(f(_m_get_ok_value())) : Result<U, E>(this->_m_err);
   }
 
   // map_err
@@ -511,9 +683,14 @@ class Result : private std::variant<Ok<T>, Err<E>> {
   constexpr Result<T, G> map_err(F&& f) noexcept(std::is_nothrow_invocable_v<F, const E&>)
     requires std::is_invocable_r_v<G, F, const E&>
   {
-    return is_err() ? Result<T, G>(f(_m_get_err_value())) : Result<T, G>(std::get<ok_t>(*this));
+    return is_err() ? Result<T, G>(f(_m_get_err_value())) : Result<T, G>(this->_m_ok);
   }
 
+  // context(), defined in context.hpp
+  // Err(e) becomes Err(ContextError<E>) with one more lazily formatted context, Ok passes through
+  template <typename... Args>
+  auto context(details::context_fmt<std::type_identity_t<Args>...> fmt, Args&&... args) &&;
+
   // map_or_else
   template <typename U, typename F, typename D>
   constexpr U map_or_else(D&& _default, F&& f) noexcept(std::is_nothrow_invocable_v<D, const E&> &&
@@ -525,15 +702,47 @@ class Result : private std::variant<Ok<T>, Err<E>> {
 
  protected:
   // uncecked get ok value
-  constexpr inline T& _m_get_ok_value() & { return std::get<ok_t>(*this).val; }
-  constexpr inline const T& _m_get_ok_value() const& { return std::get<ok_t>(*this).val; }
-  constexpr inline T&& _m_get_ok_value() && { return std::get<ok_t>(*this).val; }
-  constexpr inline const T&& _m_get_ok_value() const&& { return std::get<ok_t>(*this).val; }
+  constexpr inline details::ref_t<T> _m_get_ok_value() & noexcept {
+    if constexpr (!std::is_void_v<T>) {
+      return this->_m_ok.val;
+    }
+  }
+  constexpr inline details::cref_t<T> _m_get_ok_value() const& noexcept {
+    if constexpr (!std::is_void_v<T>) {
+      return this->_m_ok.val;
+    }
+  }
+  constexpr inline details::rref_t<T> _m_get_ok_value() && noexcept {
+    if constexpr (!std::is_void_v<T>) {
+      return std::move(this->_m_ok.val);
+    }
+  }
+  constexpr inline details::crref_t<T> _m_get_ok_value() const&& noexcept {
+    if constexpr (!std::is_void_v<T>) {
+      return std::move(this->_m_ok.val);
+    }
+  }
   // uncecked get err value
-  constexpr inline E& _m_get_err_value() & { return std::get<err_t>(*this).val; }
-  constexpr inline const E& _m_get_err_value() const& { return std::get<err_t>(*this).val; }
-  constexpr inline E&& _m_get_err_value() && { return std::get<err_t>(*this).val; }
-  constexpr inline const E&& _m_get_err_value() const&& { return std::get<err_t>(*this).val; }
+  constexpr inline details::ref_t<E> _m_get_err_value() & noexcept {
+    if constexpr (!std::is_void_v<E>) {
+      return this->_m_err.val;
+    }
+  }
+  constexpr inline details::cref_t<E> _m_get_err_value() const& noexcept {
+    if constexpr (!std::is_void_v<E>) {
+      return this->_m_err.val;
+    }
+  }
+  constexpr inline details::rref_t<E> _m_get_err_value() && noexcept {
+    if constexpr (!std::is_void_v<E>) {
+      return std::move(this->_m_err.val);
+    }
+  }
+  constexpr inline details::crref_t<E> _m_get_err_value() const&& noexcept {
+    if constexpr (!std::is_void_v<E>) {
+      return std::move(this->_m_err.val);
+    }
+  }
 };
 
 }  // namespace navp
\ No newline at end of file
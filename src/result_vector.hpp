@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <source_location>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "option_vector.hpp"
+#include "result.hpp"
+
+namespace navp {
+
+// ResultVector
+// A sequence of Result<T, E> for batches where errors are rare. Ok values live in an OptionVector<T> whose bitmap
+// is the success mask (an Err slot is None there and holds a value-initialized T), and Err values live in a sparse
+// side table of (index, error) pairs sorted by index. An element costs sizeof(T) plus one bit, plus
+// sizeof(size_t) + sizeof(E) only when it is an Err.
+template <typename T, typename E>
+class ResultVector {
+  static_assert(!std::is_void_v<T> && !std::is_void_v<E>, "ResultVector does not support void ok or err types");
+
+ public:
+  using value_type = Result<T, E>;
+  using size_type = std::size_t;
+  using error_entry = std::pair<size_type, E>;
+
+  ResultVector() = default;
+
+  template <std::ranges::input_range R>
+    requires std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Result<T, E>>
+  explicit ResultVector(R&& results) {
+    if constexpr (std::ranges::sized_range<R>) {
+      reserve(std::ranges::size(results));
+    }
+    for (auto&& r : results) {
+      push_back(std::forward<decltype(r)>(r));
+    }
+  }
+
+  // from the ok values and the errors sorted by index; values[i] is dropped for every error index i
+  // Panics with result_error unless the error indices are below values.size() and strictly increasing.
+  ResultVector(typename OptionVector<T>::storage_type values, std::vector<error_entry> errs,
+               std::source_location loc = std::source_location::current())
+      : _m_oks(std::move(values)), _m_errs(std::move(errs)) {
+    for (size_type k = 0; k < _m_errs.size(); ++k) {
+      const auto i = _m_errs[k].first;
+      if (i >= size()) [[unlikely]] {
+        details::panic<result_error>("ResultVector: error index out of range", loc);
+      }
+      if (k > 0 && i <= _m_errs[k - 1].first) [[unlikely]] {
+        details::panic<result_error>("ResultVector: error indices not strictly increasing", loc);
+      }
+      _m_oks.set(i, None);
+    }
+  }
+
+  ResultVector(std::initializer_list<Result<T, E>> list) : ResultVector(std::span(list.begin(), list.size())) {}
+
+  // capacity
+  size_type size() const noexcept { return _m_oks.size(); }
+  bool empty() const noexcept { return _m_oks.empty(); }
+  // reserves the ok values only, the error table grows on demand
+  void reserve(size_type n) { _m_oks.reserve(n); }
+  void clear() noexcept {
+    _m_oks.clear();
+    _m_errs.clear();
+  }
+
+  // modifiers
+  void push_ok(const T& val) { _m_oks.push_back(val); }
+  void push_ok(T&& val) { _m_oks.push_back(std::move(val)); }
+  void push_err(const E& err) {
+    _m_errs.emplace_back(size(), err);
+    _m_oks.push_back(None);
+  }
+  void push_err(E&& err) {
+    _m_errs.emplace_back(size(), std::move(err));
+    _m_oks.push_back(None);
+  }
+
+  void push_back(const Result<T, E>& r) {
+    if (r.is_ok()) {
+      push_ok(r.unwrap_unchecked());
+    } else {
+      push_err(r.unwrap_err_unchecked());
+    }
+  }
+  void push_back(Result<T, E>&& r) {
+    if (r.is_ok()) {
+      push_ok(std::move(r).unwrap_unchecked());
+    } else {
+      push_err(std::move(r).unwrap_err_unchecked());
+    }
+  }
+
+  void pop_back() {
+    if (is_err(size() - 1)) {
+      _m_errs.pop_back();
+    }
+    _m_oks.pop_back();
+  }
+
+  // element access
+  bool is_ok(size_type i) const noexcept { return _m_oks.is_some(i); }
+  bool is_err(size_type i) const noexcept { return _m_oks.is_none(i); }
+
+  Result<T, E> operator[](size_type i) const {
+    if (is_ok(i)) {
+      return Result<T, E>(Ok<T>(_m_oks.value_unchecked(i)));
+    }
+    return Result<T, E>(Err<E>(_m_find_err(i)->second));
+  }
+  Result<T, E> at(size_type i) const {
+    if (i >= size()) {
+      throw std::out_of_range("ResultVector::at");
+    }
+    return (*this)[i];
+  }
+
+  // the ok value in slot i, a value-initialized T when it is an Err
+  const T& ok_unchecked(size_type i) const noexcept { return _m_oks.value_unchecked(i); }
+  // the error in slot i, O(log count_err())
+  const E& err_unchecked(size_type i) const noexcept { return _m_find_err(i)->second; }
+
+  size_type count_ok() const noexcept { return size() - _m_errs.size(); }
+  size_type count_err() const noexcept { return _m_errs.size(); }
+
+  // Ok values with the success bitmap, for the bulk operations in option_vector_simd.hpp
+  const OptionVector<T>& oks() const noexcept { return _m_oks; }
+
+  // view of the Ok values in index order
+  auto ok_values() const {
+    return std::views::iota(size_type{0}, size()) | std::views::filter([this](size_type i) { return is_ok(i); }) |
+           std::views::transform([this](size_type i) -> const T& { return _m_oks.value_unchecked(i); });
+  }
+
+  // the (index, error) pairs in index order
+  std::span<const error_entry> errors() const noexcept { return _m_errs; }
+
+  std::vector<Result<T, E>> to_results() const& {
+    std::vector<Result<T, E>> out;
+    out.reserve(size());
+    auto err = _m_errs.begin();
+    for (size_type i = 0; i < size(); ++i) {
+      if (is_ok(i)) {
+        out.emplace_back(Ok<T>(_m_oks.value_unchecked(i)));
+      } else {
+        out.emplace_back(Err<E>((err++)->second));
+      }
+    }
+    return out;
+  }
+  std::vector<Result<T, E>> to_results() && {
+    std::vector<Result<T, E>> out;
+    out.reserve(size());
+    auto err = _m_errs.begin();
+    for (size_type i = 0; i < size(); ++i) {
+      if (is_ok(i)) {
+        out.emplace_back(Ok<T>(std::move(_m_oks.value_unchecked(i))));
+      } else {
+        out.emplace_back(Err<E>(std::move((err++)->second)));
+      }
+    }
+    clear();
+    return out;
+  }
+
+ private:
+  auto _m_find_err(size_type i) const noexcept {
+    return std::ranges::lower_bound(_m_errs, i, {}, &error_entry::first);
+  }
+
+  OptionVector<T> _m_oks;
+  std::vector<error_entry> _m_errs;
+};
+
+}  // namespace navp
@@ -0,0 +1,733 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result.hpp"
+
+// Lazy coroutines for I/O-bound pipelines whose stages return Result.
+//
+//   Task<Result<std::string, IoError>> fetch(EventLoop& loop, std::string key);
+//
+//   Task<Result<std::size_t, IoError>> total(EventLoop& loop, std::vector<std::string> keys) {
+//     std::vector<Task<Result<std::string, IoError>>> reads;
+//     for (auto& key : keys) reads.push_back(fetch(loop, key));
+//     auto pages = co_await when_all(std::move(reads));  // first Err, the other reads are cancelled
+//     ...
+//   }
+//   auto n = loop.run(total(loop, keys));
+//
+// A Task does nothing until it is co_awaited (with std::move for a named one) or run by EventLoop::run or
+// ThreadPool::run. The awaiter resumes the task directly. A task that finishes before suspending returns to it and
+// the awaiter carries on without suspending; one that suspends resumes the awaiter at the end by symmetric transfer.
+// Awaiting tasks in a loop therefore does not grow the stack, even in builds where GCC does not turn the transfer into
+// a tail call (below -O2).
+//
+// Cancellation is cooperative through std::stop_token: a task inherits the token of its awaiter, when_all and
+// when_any request a stop on their children once the outcome is known, then still wait for every child to finish.
+// Awaitables that suspend, like EventLoop::sleep_for, read the token with stop_token_of(handle) and finish early when
+// it is requested; a task reads it with `co_await get_stop_token()`.
+
+namespace navp {
+
+template <typename T>
+class Task;
+
+namespace details {
+
+// the stop token handed down from the awaiting coroutine
+class task_promise_base {
+ public:
+  const std::stop_token& stop_token() const noexcept { return _m_stop; }
+  void _m_set_stop_token(std::stop_token token) noexcept { _m_stop = std::move(token); }
+
+ private:
+  std::stop_token _m_stop;
+};
+
+// reads the awaiting task's stop token without suspending it
+struct get_stop_token_t {
+  explicit get_stop_token_t() = default;
+
+  bool await_ready() const noexcept { return false; }
+  template <typename Promise>
+    requires std::is_base_of_v<task_promise_base, Promise>
+  bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+    _m_token = h.promise().stop_token();
+    return false;
+  }
+  std::stop_token await_resume() noexcept { return std::move(_m_token); }
+
+  std::stop_token _m_token;
+};
+
+}  // namespace details
+
+// `std::stop_token token = co_await get_stop_token();` inside a Task
+inline details::get_stop_token_t get_stop_token() noexcept { return details::get_stop_token_t(); }
+
+// the stop token of the coroutine `h`, an empty token when it is not a Task
+template <typename Promise>
+std::stop_token stop_token_of(std::coroutine_handle<Promise> h) noexcept {
+  if constexpr (std::is_base_of_v<details::task_promise_base, Promise>) {
+    return h.promise().stop_token();
+  } else {
+    return {};
+  }
+}
+
+namespace details {
+
+template <typename T>
+class task_promise : public task_promise_base {
+ public:
+  Task<T> get_return_object() noexcept;
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+
+  struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<task_promise> h) const noexcept {
+      auto& promise = h.promise();
+      return promise._m_handoff.exchange(true, std::memory_order_acq_rel) ? promise._m_continuation
+                                                                           : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+  final_awaiter final_suspend() const noexcept { return {}; }
+
+  template <typename U>
+    requires std::is_convertible_v<U&&, T>
+  void return_value(U&& val) {
+    _m_value.emplace(std::forward<U>(val));
+  }
+  void unhandled_exception() noexcept { _m_exception = std::current_exception(); }
+
+  T _m_take() {
+#if defined(__cpp_exceptions)
+    if (_m_exception) {
+      std::rethrow_exception(_m_exception);
+    }
+#endif
+    return *std::move(_m_value);
+  }
+
+  std::coroutine_handle<> _m_continuation = std::noop_coroutine();
+  // set by whichever of Task::awaiter and final_awaiter runs first, the second one resumes the awaiter
+  std::atomic<bool> _m_handoff{false};
+
+ private:
+  // std::optional, T is usually a Result that may not be default constructible
+  std::optional<T> _m_value;
+  std::exception_ptr _m_exception;
+};
+
+}  // namespace details
+
+template <typename T>
+class [[nodiscard]] Task {
+  static_assert(!std::is_void_v<T> && !std::is_reference_v<T>, "Task<T> needs an object type, e.g. Result<void, E>");
+
+ public:
+  using promise_type = details::task_promise<T>;
+  using value_type = T;
+
+  Task(Task&& other) noexcept : _m_handle(std::exchange(other._m_handle, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      _m_destroy();
+      _m_handle = std::exchange(other._m_handle, {});
+    }
+    return *this;
+  }
+  ~Task() { _m_destroy(); }
+
+  // false until the task has run to completion
+  bool done() const noexcept { return _m_handle && _m_handle.done(); }
+
+  class awaiter {
+   public:
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) const {
+      auto& promise = _m_handle.promise();
+      promise._m_continuation = h;
+      promise._m_set_stop_token(stop_token_of(h));
+      _m_handle.resume();
+      // false when the task already finished, the awaiter then continues without a nested resume
+      return !promise._m_handoff.exchange(true, std::memory_order_acq_rel);
+    }
+    T await_resume() const { return _m_handle.promise()._m_take(); }
+
+   private:
+    friend Task;
+    explicit awaiter(std::coroutine_handle<promise_type> h) noexcept : _m_handle(h) {}
+    std::coroutine_handle<promise_type> _m_handle;
+  };
+
+  // run the task and resume the awaiter with its value, a task runs once
+  awaiter operator co_await() && noexcept { return awaiter(_m_handle); }
+
+ private:
+  friend promise_type;
+
+  explicit Task(std::coroutine_handle<promise_type> h) noexcept : _m_handle(h) {}
+
+  void _m_destroy() noexcept {
+    if (_m_handle) {
+      _m_handle.destroy();
+    }
+  }
+
+  std::coroutine_handle<promise_type> _m_handle;
+};
+
+namespace details {
+
+template <typename T>
+Task<T> task_promise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// a coroutine that starts when resumed by hand and frees itself at the end, for the blocking run() functions
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() noexcept {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+// await `task`, store its value or exception, then call done()
+template <typename T, typename Done>
+detached_task run_detached(Task<T> task, std::optional<T>& value, std::exception_ptr& exception, Done done) {
+#if defined(__cpp_exceptions)
+  try {
+    value.emplace(co_await std::move(task));
+  } catch (...) {
+    exception = std::current_exception();
+  }
+#else
+  value.emplace(co_await std::move(task));
+#endif
+  done();
+}
+
+// counts down the children of when_all/when_any, the last one to finish resumes the parent
+struct join_counter {
+  std::atomic<std::size_t> remaining;
+  std::coroutine_handle<> parent;
+
+  // true for the caller that brings the count to zero
+  bool arrive() noexcept { return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+// one child of when_all/when_any: awaits the task with the join's stop token and reports to the join
+struct join_child {
+  class promise_type : public task_promise_base {
+   public:
+    join_child get_return_object() noexcept { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    struct final_awaiter {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+        auto& counter = *h.promise()._m_counter;
+        return counter.arrive() ? counter.parent : std::noop_coroutine();
+      }
+      void await_resume() const noexcept {}
+    };
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    // the body catches everything
+    void unhandled_exception() const noexcept { std::terminate(); }
+
+    join_counter* _m_counter = nullptr;
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename R, typename State>
+join_child join_one(Task<R> task, State& state, std::size_t i) {
+#if defined(__cpp_exceptions)
+  try {
+    state._m_on_result(i, co_await std::move(task));
+  } catch (...) {
+    state._m_on_exception(std::current_exception());
+  }
+#else
+  state._m_on_result(i, co_await std::move(task));
+#endif
+}
+
+// runs the children of when_all/when_any, forwards the parent's cancellation and keeps the first exception
+class join_base {
+ public:
+  explicit join_base(std::size_t n) : _m_counter{n + 1, {}} { _m_children.reserve(n); }
+  join_base(const join_base&) = delete;
+  join_base& operator=(const join_base&) = delete;
+  ~join_base() {
+    for (auto& child : _m_children) {
+      child.handle.destroy();
+    }
+  }
+
+  void _m_add(join_child child) {
+    child.handle.promise()._m_counter = &_m_counter;
+    child.handle.promise()._m_set_stop_token(_m_source.get_token());
+    _m_children.push_back(child);
+  }
+
+  // starts every child, the awaiter resumes once all of them are done
+  struct run_awaiter {
+    join_base& join;
+
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) {
+      join._m_counter.parent = h;
+      if (auto token = stop_token_of(h); token.stop_possible()) {
+        join._m_forward.emplace(std::move(token), request_stop_fn{&join._m_source});
+      }
+      for (auto& child : join._m_children) {
+        child.handle.resume();
+      }
+      // false when every child already finished, the parent then continues right away
+      return !join._m_counter.arrive();
+    }
+    void await_resume() const noexcept {}
+  };
+  run_awaiter _m_run() noexcept { return {*this}; }
+
+  void _m_on_exception(std::exception_ptr e) noexcept {
+    {
+      std::lock_guard lock(_m_exception_mutex);
+      if (!_m_exception) {
+        _m_exception = std::move(e);
+      }
+    }
+    _m_source.request_stop();
+  }
+
+  void _m_rethrow() const {
+#if defined(__cpp_exceptions)
+    if (_m_exception) {
+      std::rethrow_exception(_m_exception);
+    }
+#endif
+  }
+
+ protected:
+  std::stop_source _m_source;
+
+ private:
+  struct request_stop_fn {
+    std::stop_source* source;
+    void operator()() const noexcept { source->request_stop(); }
+  };
+
+  join_counter _m_counter;
+  std::vector<join_child> _m_children;
+  std::optional<std::stop_callback<request_stop_fn>> _m_forward;
+  std::mutex _m_exception_mutex;
+  std::exception_ptr _m_exception;
+};
+
+template <typename T, typename E>
+using when_all_result_t = std::conditional_t<std::is_void_v<T>, Result<void, E>, Result<std::vector<T>, E>>;
+
+template <typename T, typename E>
+class when_all_state : public join_base {
+  static_assert(!std::is_void_v<E>, "when_all needs an error type");
+
+ public:
+  explicit when_all_state(std::size_t n) : join_base(n) {
+    if constexpr (!std::is_void_v<T>) {
+      _m_values.resize(n);
+    }
+  }
+
+  void _m_on_result(std::size_t i, Result<T, E>&& r) {
+    if (r.is_ok()) {
+      if constexpr (!std::is_void_v<T>) {
+        _m_values[i].emplace(std::move(r).unwrap_unchecked());
+      }
+    } else if (!_m_failed.exchange(true, std::memory_order_acq_rel)) {
+      _m_error.emplace(std::move(r).unwrap_err_unchecked());
+      _m_source.request_stop();
+    }
+  }
+
+  when_all_result_t<T, E> _m_take() {
+    if (_m_failed.load(std::memory_order_acquire)) {
+      return Err<E>(*std::move(_m_error));
+    }
+    if constexpr (std::is_void_v<T>) {
+      return Ok<void>();
+    } else {
+      std::vector<T> out;
+      out.reserve(_m_values.size());
+      for (auto& val : _m_values) {
+        out.push_back(*std::move(val));
+      }
+      return Ok<std::vector<T>>(std::move(out));
+    }
+  }
+
+ private:
+  struct empty {};
+  [[no_unique_address]] std::conditional_t<std::is_void_v<T>, empty, std::vector<std::optional<T>>> _m_values;
+  std::atomic<bool> _m_failed{false};
+  std::optional<E> _m_error;
+};
+
+template <typename T, typename E>
+class when_any_state : public join_base {
+  static_assert(!std::is_void_v<E>, "when_any needs an error type");
+
+ public:
+  using join_base::join_base;
+
+  void _m_on_result(std::size_t, Result<T, E>&& r) {
+    if (r.is_ok()) {
+      if (!_m_won.exchange(true, std::memory_order_acq_rel)) {
+        if constexpr (!std::is_void_v<T>) {
+          _m_value.emplace(std::move(r).unwrap_unchecked());
+        }
+        _m_source.request_stop();
+      }
+    } else if (!_m_failed.exchange(true, std::memory_order_acq_rel)) {
+      _m_error.emplace(std::move(r).unwrap_err_unchecked());
+    }
+  }
+
+  Result<T, E> _m_take() {
+    if (!_m_won.load(std::memory_order_acquire)) {
+      return Err<E>(*std::move(_m_error));
+    }
+    if constexpr (std::is_void_v<T>) {
+      return Ok<void>();
+    } else {
+      return Ok<T>(*std::move(_m_value));
+    }
+  }
+
+ private:
+  struct empty {};
+  [[no_unique_address]] std::conditional_t<std::is_void_v<T>, empty, std::optional<T>> _m_value;
+  std::atomic<bool> _m_won{false};
+  std::atomic<bool> _m_failed{false};
+  std::optional<E> _m_error;
+};
+
+}  // namespace details
+
+// Run every task concurrently. Ok with all the values in task order, or the first Err to happen; the other tasks
+// are then asked to stop and awaited before it is returned. An exception thrown by a task is rethrown.
+template <typename T, typename E>
+Task<details::when_all_result_t<T, E>> when_all(std::vector<Task<Result<T, E>>> tasks) {
+  details::when_all_state<T, E> state(tasks.size());
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    state._m_add(details::join_one(std::move(tasks[i]), state, i));
+  }
+  co_await state._m_run();
+  state._m_rethrow();
+  co_return state._m_take();
+}
+
+// Run every task concurrently. The first Ok to happen, the other tasks are then asked to stop and awaited before it
+// is returned; the first Err to happen when none succeeds. `tasks` must not be empty.
+template <typename T, typename E>
+Task<Result<T, E>> when_any(std::vector<Task<Result<T, E>>> tasks) {
+  if (tasks.empty()) [[unlikely]] {
+    details::panic<result_error>("when_any of no tasks", std::source_location::current());
+  }
+  details::when_any_state<T, E> state(tasks.size());
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    state._m_add(details::join_one(std::move(tasks[i]), state, i));
+  }
+  co_await state._m_run();
+  state._m_rethrow();
+  co_return state._m_take();
+}
+
+// Single-threaded scheduler: run() resumes coroutines on the calling thread until the task is done. post() may be
+// called from any thread, e.g. by an I/O completion thread.
+class EventLoop {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  class sleep_awaiter;
+
+  EventLoop() = default;
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  // resume `h` from run()
+  void post(std::coroutine_handle<> h) {
+    {
+      std::lock_guard lock(_m_mutex);
+      _m_ready.push_back(h);
+    }
+    _m_wake.notify_one();
+  }
+
+  // yield to the other ready coroutines
+  auto schedule() noexcept {
+    struct awaiter {
+      EventLoop& loop;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) const { loop.post(h); }
+      void await_resume() const noexcept {}
+    };
+    return awaiter{*this};
+  }
+
+  // `co_await loop.sleep_for(d)` is true after `d`, false when the task was asked to stop first
+  sleep_awaiter sleep_for(clock::duration d) noexcept;
+  sleep_awaiter sleep_until(clock::time_point deadline) noexcept;
+
+  // run `task` and the coroutines it posts until it is done, then return its value
+  template <typename T>
+  T run(Task<T> task) {
+    std::optional<T> value;
+    std::exception_ptr exception;
+    bool done = false;
+    auto runner = details::run_detached(std::move(task), value, exception, [this, &done] {
+      std::lock_guard lock(_m_mutex);
+      done = true;
+      _m_wake.notify_one();
+    });
+    post(runner.handle);
+
+    std::unique_lock lock(_m_mutex);
+    while (!done) {
+      for (auto now = clock::now(); !_m_timers.empty() && _m_timers.begin()->first <= now;) {
+        _m_ready.push_back(_m_fire(_m_timers.begin()));
+      }
+      if (!_m_ready.empty()) {
+        auto h = _m_ready.front();
+        _m_ready.pop_front();
+        lock.unlock();
+        h.resume();
+        lock.lock();
+      } else if (_m_timers.empty()) {
+        _m_wake.wait(lock);
+      } else {
+        _m_wake.wait_until(lock, _m_timers.begin()->first);
+      }
+    }
+    lock.unlock();
+
+#if defined(__cpp_exceptions)
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+#endif
+    return *std::move(value);
+  }
+
+ private:
+  using timer_map = std::multimap<clock::time_point, sleep_awaiter*>;
+
+  // disarm a timer, the caller holds the lock
+  std::coroutine_handle<> _m_fire(timer_map::iterator it) noexcept;
+
+  std::mutex _m_mutex;
+  std::condition_variable _m_wake;
+  std::deque<std::coroutine_handle<>> _m_ready;
+  timer_map _m_timers;
+};
+
+class EventLoop::sleep_awaiter {
+ public:
+  sleep_awaiter(EventLoop& loop, clock::time_point deadline) noexcept : _m_loop(loop), _m_deadline(deadline) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> h) {
+    _m_handle = h;
+    auto token = stop_token_of(h);
+    if (token.stop_requested()) {
+      _m_cancelled = true;
+      return false;
+    }
+    // the callback may run right here, it then only marks the awaiter cancelled
+    if (token.stop_possible()) {
+      _m_on_stop.emplace(std::move(token), cancel_fn{this});
+    }
+    auto& loop = _m_loop;
+    {
+      std::lock_guard lock(loop._m_mutex);
+      if (_m_cancelled) {
+        return false;
+      }
+      _m_timer = loop._m_timers.emplace(_m_deadline, this);
+      _m_armed = true;
+    }
+    // run() may be waiting for an earlier deadline; `this` may already be resumed and gone here
+    loop._m_wake.notify_one();
+    return true;
+  }
+
+  bool await_resume() noexcept {
+    // waits for a stop callback running on another thread
+    _m_on_stop.reset();
+    return !_m_cancelled;
+  }
+
+ private:
+  friend EventLoop;
+
+  struct cancel_fn {
+    sleep_awaiter* self;
+    void operator()() const { self->_m_cancel(); }
+  };
+
+  void _m_cancel() {
+    {
+      std::lock_guard lock(_m_loop._m_mutex);
+      _m_cancelled = true;
+      if (!_m_armed) {
+        return;
+      }
+      _m_loop._m_timers.erase(_m_timer);
+      _m_armed = false;
+    }
+    _m_loop.post(_m_handle);
+  }
+
+  EventLoop& _m_loop;
+  clock::time_point _m_deadline;
+  std::coroutine_handle<> _m_handle;
+  timer_map::iterator _m_timer;
+  // guarded by the loop's mutex once the awaiter is suspended
+  bool _m_armed = false;
+  bool _m_cancelled = false;
+  std::optional<std::stop_callback<cancel_fn>> _m_on_stop;
+};
+
+inline EventLoop::sleep_awaiter EventLoop::sleep_for(clock::duration d) noexcept {
+  return sleep_awaiter(*this, clock::now() + d);
+}
+
+inline EventLoop::sleep_awaiter EventLoop::sleep_until(clock::time_point deadline) noexcept {
+  return sleep_awaiter(*this, deadline);
+}
+
+inline std::coroutine_handle<> EventLoop::_m_fire(timer_map::iterator it) noexcept {
+  auto* awaiter = it->second;
+  awaiter->_m_armed = false;
+  _m_timers.erase(it);
+  return awaiter->_m_handle;
+}
+
+// Multi-threaded scheduler: a fixed set of worker threads resuming the coroutines posted to one shared queue.
+class ThreadPool {
+ public:
+  // `threads` workers, 0 for std::thread::hardware_concurrency()
+  explicit ThreadPool(unsigned threads = 0) {
+    const auto n = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    _m_workers.reserve(n);
+    for (unsigned i = 0; i < n; ++i) {
+      _m_workers.emplace_back([this](std::stop_token stop) { _m_work(stop); });
+    }
+  }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  unsigned threads() const noexcept { return static_cast<unsigned>(_m_workers.size()); }
+
+  // resume `h` on a worker
+  void post(std::coroutine_handle<> h) {
+    {
+      std::lock_guard lock(_m_mutex);
+      _m_queue.push_back(h);
+    }
+    _m_wake.notify_one();
+  }
+
+  // continue on a worker
+  auto schedule() noexcept {
+    struct awaiter {
+      ThreadPool& pool;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) const { pool.post(h); }
+      void await_resume() const noexcept {}
+    };
+    return awaiter{*this};
+  }
+
+  // run `task` on the workers and block the calling thread until it is done
+  template <typename T>
+  T run(Task<T> task) {
+    std::optional<T> value;
+    std::exception_ptr exception;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    auto runner = details::run_detached(std::move(task), value, exception, [&] {
+      // notify under the lock, the waiter destroys cv as soon as it sees done
+      std::lock_guard lock(mutex);
+      done = true;
+      cv.notify_one();
+    });
+    post(runner.handle);
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [&] { return done; });
+    }
+
+#if defined(__cpp_exceptions)
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+#endif
+    return *std::move(value);
+  }
+
+ private:
+  void _m_work(std::stop_token stop) {
+    for (;;) {
+      std::coroutine_handle<> h;
+      {
+        std::unique_lock lock(_m_mutex);
+        if (!_m_wake.wait(lock, stop, [this] { return !_m_queue.empty(); })) {
+          return;
+        }
+        h = _m_queue.front();
+        _m_queue.pop_front();
+      }
+      h.resume();
+    }
+  }
+
+  std::mutex _m_mutex;
+  std::condition_variable_any _m_wake;
+  std::deque<std::coroutine_handle<>> _m_queue;
+  // last, the workers are stopped and joined before the queue goes away
+  std::vector<std::jthread> _m_workers;
+};
+
+}  // namespace navp
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ranges>
 #include <type_traits>
 
 namespace navp::details {
@@ -9,4 +10,12 @@ struct is_instance_of : std::false_type {};
 template <template <typename...> class Template, typename... Args>
 struct is_instance_of<Template<Args...>, Template> : std::true_type {};
 
+// the element type of a range, e.g. Option<T> or Result<T, E>
+template <typename R>
+using range_elem_t = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+// input range whose elements are instances of Tmpl
+template <typename R, template <typename...> typename Tmpl>
+concept range_of = std::ranges::input_range<R> && is_instance_of<range_elem_t<R>, Tmpl>::value;
+
 }  // namespace navp::details
\ No newline at end of file
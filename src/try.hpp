@@ -0,0 +1,87 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "template_utils.hpp"
+
+// Early-return propagation for functions returning Result or Option, the macro counterpart of co_await in
+// coroutine.hpp without a coroutine frame.
+//
+//   Result<int, ParseError> total(std::string_view a, std::string_view b) {
+//     int x = NAVP_TRY(parse(a));  // returns parse(a)'s Err from total() if there is one
+//     NAVP_TRY_ASSIGN(int y, parse(b));
+//     return Ok(x + y);
+//   }
+//
+// NAVP_TRY(expr) is a GCC/Clang statement expression yielding the Ok/Some value. NAVP_TRY_ASSIGN(lhs, expr) and
+// NAVP_TRY_DISCARD(expr) are plain statements and work everywhere. On failure the Err is moved out of an rvalue
+// operand (copied from an lvalue one) and returned as Err<E>, or None is returned for an Option; the enclosing
+// function's return type must be constructible from it.
+
+namespace navp::details {
+
+template <typename T, typename E>
+constexpr bool try_ok(const Result<T, E>& r) noexcept {
+  return r.is_ok();
+}
+template <typename T>
+constexpr bool try_ok(const Option<T>& op) noexcept {
+  return op.is_some();
+}
+
+// the early return value, the Err of an rvalue is moved
+template <typename R>
+  requires is_instance_of<std::remove_cvref_t<R>, Result>::value
+constexpr auto try_fail(R&& r) {
+  using E = typename std::remove_cvref_t<R>::err_type;
+  if constexpr (std::is_void_v<E>) {
+    return Err<void>();
+  } else {
+    return Err<E>(std::forward<R>(r).unwrap_err_unchecked());
+  }
+}
+template <typename O>
+  requires is_instance_of<std::remove_cvref_t<O>, Option>::value
+constexpr NoneType try_fail(O&&) noexcept {
+  return None;
+}
+
+template <typename R>
+constexpr decltype(auto) try_value(R&& r) {
+  return std::forward<R>(r).unwrap_unchecked();
+}
+
+}  // namespace navp::details
+
+#define NAVP_TRY_CONCAT_IMPL_(a, b) a##b
+#define NAVP_TRY_CONCAT_(a, b) NAVP_TRY_CONCAT_IMPL_(a, b)
+
+#define NAVP_TRY_RETURN_IF_FAILED_(tmp, ...)                              \
+  auto&& tmp = (__VA_ARGS__);                                             \
+  if (!::navp::details::try_ok(tmp)) [[unlikely]] {                       \
+    return ::navp::details::try_fail(static_cast<decltype(tmp)&&>(tmp)); \
+  }
+
+#if defined(__GNUC__)
+// the Ok/Some value of expr, or return its Err/None from the enclosing function
+#define NAVP_TRY(...)                                                                   \
+  __extension__({                                                                       \
+    NAVP_TRY_RETURN_IF_FAILED_(_navp_try_tmp, __VA_ARGS__)                              \
+    ::navp::details::try_value(static_cast<decltype(_navp_try_tmp)&&>(_navp_try_tmp)); \
+  })
+#endif
+
+// `lhs = <Ok/Some value of expr>;`, lhs is a declaration such as `auto x` or an existing lvalue. At most one per line.
+#define NAVP_TRY_ASSIGN(lhs, ...) NAVP_TRY_ASSIGN_IMPL_(NAVP_TRY_CONCAT_(_navp_try_tmp_, __LINE__), lhs, __VA_ARGS__)
+#define NAVP_TRY_ASSIGN_IMPL_(tmp, lhs, ...)    \
+  NAVP_TRY_RETURN_IF_FAILED_(tmp, __VA_ARGS__) \
+  lhs = ::navp::details::try_value(static_cast<decltype(tmp)&&>(tmp))
+
+// return the Err/None of expr from the enclosing function, drop the value otherwise
+#define NAVP_TRY_DISCARD(...)                              \
+  do {                                                     \
+    NAVP_TRY_RETURN_IF_FAILED_(_navp_try_tmp, __VA_ARGS__) \
+  } while (false)
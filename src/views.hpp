@@ -0,0 +1,357 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "template_utils.hpp"
+
+// Lazy range adaptors over ranges of Option and Result. None of them allocate.
+//
+//   views::somes         the values of the Some elements
+//   views::oks           the values of the Ok elements
+//   views::errs          the errors of the Err elements
+//   views::and_then(f)   f(value) for every Ok element, ending right after the first Err
+//
+// e.g. `lines | std::views::transform(parse) | navp::views::oks`. When the underlying range yields lvalues the
+// adaptors yield references into it. When it yields prvalues (like a transform) each element is evaluated once
+// and kept in the view until the iterator advances, so these views are then single-pass input ranges.
+
+namespace navp {
+
+namespace details {
+
+#if defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 202202L
+template <typename D>
+using adaptor_closure = std::ranges::range_adaptor_closure<D>;
+#else
+template <typename D>
+using adaptor_closure = std::views::__adaptor::_RangeAdaptorClosure;
+#endif
+
+// which elements an unwrap_view keeps and what it yields for them
+template <typename Elem>
+struct somes_kind {
+  using type = typename Elem::value_type;
+  static constexpr bool keep(const Elem& elem) noexcept { return elem.is_some(); }
+  static constexpr type& get(const Elem& elem) noexcept { return elem.unwrap_unchecked(); }
+};
+
+template <typename Elem>
+struct oks_kind {
+  using type = typename Elem::ok_type;
+  static constexpr bool keep(const Elem& elem) noexcept { return elem.is_ok(); }
+  static constexpr type& get(const Elem& elem) noexcept { return elem.unwrap_unchecked(); }
+};
+
+template <typename Elem>
+struct errs_kind {
+  using type = typename Elem::err_type;
+  static constexpr bool keep(const Elem& elem) noexcept { return elem.is_err(); }
+  static constexpr type& get(const Elem& elem) noexcept { return elem.unwrap_err_unchecked(); }
+};
+
+// filter + unwrap in one pass, see views::somes/oks/errs
+template <std::ranges::input_range V, template <typename> typename Kind>
+  requires std::ranges::view<V>
+class unwrap_view : public std::ranges::view_interface<unwrap_view<V, Kind>> {
+  using _Elem = std::ranges::range_value_t<V>;
+  using _Kind = Kind<_Elem>;
+  using _BaseRef = std::ranges::range_reference_t<V>;
+  // the underlying range yields prvalues or xvalues, the current element lives in _m_cache
+  static constexpr bool _s_cached = !std::is_lvalue_reference_v<_BaseRef>;
+  static constexpr bool _s_forward = !_s_cached && std::ranges::forward_range<V>;
+
+  using _Value = typename _Kind::type;
+  using _Ref = std::conditional_t<!_s_cached && std::is_const_v<std::remove_reference_t<_BaseRef>>, const _Value&,
+                                  _Value&>;
+
+ public:
+  class sentinel;
+
+  class iterator {
+   public:
+    using iterator_concept = std::conditional_t<_s_forward, std::forward_iterator_tag, std::input_iterator_tag>;
+    using value_type = std::remove_cv_t<_Value>;
+    using difference_type = std::ranges::range_difference_t<V>;
+
+    iterator() = default;
+
+    constexpr _Ref operator*() const {
+      if constexpr (_s_cached) {
+        return _Kind::get(*_m_parent->_m_cache);
+      } else {
+        return _Kind::get(*_m_cur);
+      }
+    }
+
+    constexpr iterator& operator++() {
+      ++_m_cur;
+      _m_satisfy();
+      return *this;
+    }
+    constexpr void operator++(int) { ++*this; }
+    constexpr iterator operator++(int)
+      requires _s_forward
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+      requires _s_forward
+    {
+      return lhs._m_cur == rhs._m_cur;
+    }
+
+   private:
+    friend class unwrap_view;
+    friend class sentinel;
+
+    constexpr iterator(unwrap_view* parent, std::ranges::iterator_t<V> cur)
+        : _m_parent(parent), _m_cur(std::move(cur)) {}
+
+    // advance to the next element that is kept
+    constexpr void _m_satisfy() {
+      const auto end = std::ranges::end(_m_parent->_m_base);
+      for (; _m_cur != end; ++_m_cur) {
+        if constexpr (_s_cached) {
+          if (_Kind::keep(_m_parent->_m_cache.emplace(*_m_cur))) {
+            return;
+          }
+        } else if (_Kind::keep(*_m_cur)) {
+          return;
+        }
+      }
+    }
+
+    unwrap_view* _m_parent = nullptr;
+    std::ranges::iterator_t<V> _m_cur{};
+  };
+
+  class sentinel {
+   public:
+    sentinel() = default;
+
+    friend constexpr bool operator==(const iterator& it, const sentinel& s) { return s._m_equal(it); }
+
+   private:
+    friend class unwrap_view;
+    constexpr explicit sentinel(std::ranges::sentinel_t<V> end) : _m_end(std::move(end)) {}
+
+    constexpr bool _m_equal(const iterator& it) const { return it._m_cur == _m_end; }
+
+    std::ranges::sentinel_t<V> _m_end{};
+  };
+
+  unwrap_view()
+    requires std::default_initializable<V>
+  = default;
+  constexpr explicit unwrap_view(V base) : _m_base(std::move(base)) {}
+
+  constexpr V base() const&
+    requires std::copy_constructible<V>
+  {
+    return _m_base;
+  }
+  constexpr V base() && { return std::move(_m_base); }
+
+  constexpr iterator begin() {
+    iterator it(this, std::ranges::begin(_m_base));
+    it._m_satisfy();
+    return it;
+  }
+  constexpr sentinel end() { return sentinel(std::ranges::end(_m_base)); }
+
+ private:
+  V _m_base = V();
+  [[no_unique_address]] std::conditional_t<_s_cached, std::optional<_Elem>, std::monostate> _m_cache;
+};
+
+template <template <typename> typename Kind, template <typename...> typename Tmpl>
+struct unwrap_fn : adaptor_closure<unwrap_fn<Kind, Tmpl>> {
+  template <std::ranges::viewable_range R>
+    requires range_of<R, Tmpl>
+  constexpr auto operator()(R&& range) const {
+    return unwrap_view<std::views::all_t<R>, Kind>(std::views::all(std::forward<R>(range)));
+  }
+};
+
+// copyable and assignable holder for a callable, lambdas with captures are not assignable
+template <typename F>
+class fn_box {
+ public:
+  fn_box() = default;
+  constexpr explicit fn_box(F f) : _m_f(std::move(f)) {}
+  fn_box(const fn_box&) = default;
+  fn_box(fn_box&&) = default;
+  constexpr fn_box& operator=(const fn_box& other) {
+    if (this != &other) {
+      other._m_f ? (void)_m_f.emplace(*other._m_f) : _m_f.reset();
+    }
+    return *this;
+  }
+  constexpr fn_box& operator=(fn_box&& other) noexcept(std::is_nothrow_move_constructible_v<F>) {
+    if (this != &other) {
+      other._m_f ? (void)_m_f.emplace(std::move(*other._m_f)) : _m_f.reset();
+    }
+    return *this;
+  }
+
+  constexpr const F& operator*() const noexcept { return *_m_f; }
+
+ private:
+  std::optional<F> _m_f;
+};
+
+// see views::and_then
+template <std::ranges::input_range V, typename F>
+  requires std::ranges::view<V> && range_of<V, Result>
+class and_then_view : public std::ranges::view_interface<and_then_view<V, F>> {
+  using _In = std::ranges::range_value_t<V>;
+  using _E = typename _In::err_type;
+  // the ok value, moved from when the underlying range yields rvalues
+  using _Arg = decltype(std::declval<std::ranges::range_reference_t<V>>().unwrap_unchecked());
+  using _Out = std::remove_cvref_t<std::invoke_result_t<const F&, _Arg>>;
+  static_assert(is_instance_of<_Out, Result>::value && std::is_same_v<typename _Out::err_type, _E>,
+                "views::and_then(f) needs f to return a Result with the same error type");
+
+ public:
+  class sentinel;
+
+  class iterator {
+   public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = _Out;
+    using difference_type = std::ranges::range_difference_t<V>;
+
+    constexpr _Out& operator*() const { return *_m_parent->_m_cache; }
+
+    constexpr iterator& operator++() {
+      if (_m_parent->_m_cache->is_err()) {
+        _m_parent->_m_done = true;
+      } else {
+        ++_m_cur;
+        _m_fill();
+      }
+      return *this;
+    }
+    constexpr void operator++(int) { ++*this; }
+
+   private:
+    friend class and_then_view;
+    friend class sentinel;
+
+    constexpr iterator(and_then_view* parent, std::ranges::iterator_t<V> cur)
+        : _m_parent(parent), _m_cur(std::move(cur)) {}
+
+    // evaluate the element at _m_cur into the cache
+    constexpr void _m_fill() {
+      if (_m_cur == std::ranges::end(_m_parent->_m_base)) {
+        return;
+      }
+      decltype(auto) in = *_m_cur;
+      if (in.is_ok()) {
+        _m_parent->_m_cache.emplace((*_m_parent->_m_fn)(std::forward<decltype(in)>(in).unwrap_unchecked()));
+      } else {
+        _m_parent->_m_cache.emplace(Err<_E>(std::forward<decltype(in)>(in).unwrap_err_unchecked()));
+      }
+    }
+
+    and_then_view* _m_parent = nullptr;
+    std::ranges::iterator_t<V> _m_cur{};
+  };
+
+  class sentinel {
+   public:
+    sentinel() = default;
+
+    friend constexpr bool operator==(const iterator& it, const sentinel& s) { return s._m_equal(it); }
+
+   private:
+    friend class and_then_view;
+    constexpr explicit sentinel(std::ranges::sentinel_t<V> end) : _m_end(std::move(end)) {}
+
+    constexpr bool _m_equal(const iterator& it) const { return it._m_parent->_m_done || it._m_cur == _m_end; }
+
+    std::ranges::sentinel_t<V> _m_end{};
+  };
+
+  and_then_view()
+    requires std::default_initializable<V> && std::default_initializable<F>
+  = default;
+  constexpr and_then_view(V base, F fn) : _m_base(std::move(base)), _m_fn(std::move(fn)) {}
+
+  constexpr V base() const&
+    requires std::copy_constructible<V>
+  {
+    return _m_base;
+  }
+  constexpr V base() && { return std::move(_m_base); }
+
+  constexpr iterator begin() {
+    _m_done = false;
+    iterator it(this, std::ranges::begin(_m_base));
+    it._m_fill();
+    return it;
+  }
+  constexpr sentinel end() { return sentinel(std::ranges::end(_m_base)); }
+
+ private:
+  V _m_base = V();
+  fn_box<F> _m_fn;
+  std::optional<_Out> _m_cache;
+  bool _m_done = false;
+};
+
+template <typename F>
+struct and_then_closure : adaptor_closure<and_then_closure<F>> {
+  F fn;
+
+  template <std::ranges::viewable_range R>
+    requires range_of<R, Result>
+  constexpr auto operator()(R&& range) const& {
+    return and_then_view<std::views::all_t<R>, F>(std::views::all(std::forward<R>(range)), fn);
+  }
+  template <std::ranges::viewable_range R>
+    requires range_of<R, Result>
+  constexpr auto operator()(R&& range) && {
+    return and_then_view<std::views::all_t<R>, F>(std::views::all(std::forward<R>(range)), std::move(fn));
+  }
+};
+
+struct and_then_fn {
+  template <std::ranges::viewable_range R, typename F>
+    requires range_of<R, Result>
+  constexpr auto operator()(R&& range, F&& fn) const {
+    return and_then_view<std::views::all_t<R>, std::decay_t<F>>(std::views::all(std::forward<R>(range)),
+                                                                  std::forward<F>(fn));
+  }
+  template <typename F>
+  constexpr auto operator()(F&& fn) const {
+    return and_then_closure<std::decay_t<F>>{{}, std::forward<F>(fn)};
+  }
+};
+
+}  // namespace details
+
+namespace views {
+
+inline constexpr details::unwrap_fn<details::somes_kind, Option> somes{};
+inline constexpr details::unwrap_fn<details::oks_kind, Result> oks{};
+inline constexpr details::unwrap_fn<details::errs_kind, Result> errs{};
+
+// f takes the ok value (the element's reference type) and returns a Result with the same error type. An Err
+// element, or an Err returned by f, is yielded and ends the range.
+inline constexpr details::and_then_fn and_then{};
+
+}  // namespace views
+
+}  // namespace navp
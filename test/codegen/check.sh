@@ -0,0 +1,98 @@
+#!/bin/sh
+# Codegen regression check: the hot path of every unwrap-like call site must not be longer than
+# std::optional<int>::value(), i.e. a tag test, a load and a call to an out-of-line failure stub.
+# The NAVP_TRY macros must compile to the same code as a hand-written early return, see try.cpp.
+#
+# usage: test/codegen/check.sh [extra compiler flags...]   (CXX selects the compiler, default c++)
+
+set -e
+
+cd "$(dirname "$0")"
+CXX=${CXX:-c++}
+ASM=$(mktemp)
+TRY_ASM=$(mktemp)
+trap 'rm -f "$ASM" "$TRY_ASM"' EXIT
+
+$CXX -std=c++23 -O2 -S -fno-asynchronous-unwind-tables -I../../src "$@" unwrap.cpp -o "$ASM"
+# no identical code folding, it would turn one function of a pair into a jump to the other
+$CXX -std=c++23 -O2 -S -fno-asynchronous-unwind-tables -fno-ipa-icf -I../../src "$@" try.cpp -o "$TRY_ASM"
+
+# instructions of the hot part of function $1 in $2 (cold parts live in separate `$1.cold` symbols), labels renamed
+body() {
+  awk -v fn="$1" '
+    $0 == fn ":" { inside = 1; next }
+    inside && /^\.L[0-9]+:/ { print ".L:"; next }
+    inside && /^[^ \t.]/ { exit }
+    inside && /^\t\.size/ { exit }
+    inside && /^\t[a-z]/ { gsub(/\.L[0-9]+/, ".L"); print }
+  ' "$2"
+}
+
+# number of instructions in the hot part of function $1
+count() {
+  body "$1" "$ASM" | grep -vc '^\.L:' || true
+}
+
+# number of instructions run from the entry of function $1 to its first ret, falling through conditional branches
+# (the unlikely side is laid out out of line) and following unconditional jumps
+ok_path() {
+  awk -v fn="$1" '
+    $0 == fn ":" { inside = 1; next }
+    inside && /^\.L[0-9]+:/ { sub(":", "", $1); label[$1] = n; next }
+    inside && /^[^ \t.]/ { exit }
+    inside && /^\t\.size/ { exit }
+    inside && /^\t[a-z]/ { op[n] = $1; arg[n] = $2; n++ }
+    END {
+      i = 0
+      steps = 0
+      while (i < n && steps < 1000) {
+        steps++
+        if (op[i] == "ret" || (op[i] == "jmp" && !(arg[i] in label))) break
+        i = op[i] == "jmp" ? label[arg[i]] : i + 1
+      }
+      print steps
+    }
+  ' "$TRY_ASM"
+}
+
+baseline=$(count std_optional_value)
+echo "std_optional_value: $baseline"
+status=0
+for fn in navp_option_unwrap navp_option_expect navp_option_ptr_unwrap navp_result_unwrap navp_result_expect \
+  navp_result_unwrap_err; do
+  n=$(count $fn)
+  if [ "$n" -eq 0 ] || [ "$n" -gt "$baseline" ]; then
+    echo "$fn: $n  FAILED (baseline $baseline)"
+    status=1
+  else
+    echo "$fn: $n"
+  fi
+done
+
+# hand-written function, then the NAVP_TRY_ASSIGN/NAVP_TRY_DISCARD functions that must be identical to it
+for pair in hand_result:try_assign_result hand_string:try_assign_string hand_option:try_assign_option \
+  hand_discard:try_discard; do
+  hand=${pair%%:*}
+  fn=${pair#*:}
+  if [ -z "$(body $hand "$TRY_ASM")" ] || [ "$(body $hand "$TRY_ASM")" != "$(body $fn "$TRY_ASM")" ]; then
+    echo "$fn: FAILED (differs from $hand)"
+    status=1
+  else
+    echo "$fn: same as $hand"
+  fi
+done
+
+# hand-written function, then the NAVP_TRY function whose Ok path must not be longer
+for pair in hand_result:try_result hand_string:try_string hand_option:try_option; do
+  hand=${pair%%:*}
+  fn=${pair#*:}
+  h=$(ok_path $hand)
+  n=$(ok_path $fn)
+  if [ "$n" -le 1 ] || [ "$n" -gt "$h" ]; then
+    echo "$fn: ok path $n  FAILED ($hand: $h)"
+    status=1
+  else
+    echo "$fn: ok path $n ($hand: $h)"
+  fi
+done
+exit $status
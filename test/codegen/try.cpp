@@ -0,0 +1,79 @@
+// Functions compared by check.sh against the hand-written branch next to them. NAVP_TRY_ASSIGN and NAVP_TRY_DISCARD
+// must compile to the same instructions. A GCC statement expression gets its own block layout (the early return is
+// tail-duplicated), so NAVP_TRY must only have an Ok path no longer than the hand-written one.
+#include <string>
+
+#include "option.hpp"
+#include "result.hpp"
+#include "try.hpp"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+
+// defined elsewhere so the calls stay opaque
+Result<int, int> step(int x);
+Result<int, std::string> step_string(int x);
+Option<int> step_option(int x);
+
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#endif
+
+extern "C" {
+
+Result<int, int> hand_result(int x) {
+  auto r = step(x);
+  if (r.is_err()) [[unlikely]] {
+    return Err(std::move(r).unwrap_err_unchecked());
+  }
+  int v = std::move(r).unwrap_unchecked();
+  return Ok(v + 1);
+}
+Result<int, int> try_result(int x) { return Ok(NAVP_TRY(step(x)) + 1); }
+Result<int, int> try_assign_result(int x) {
+  NAVP_TRY_ASSIGN(int v, step(x));
+  return Ok(v + 1);
+}
+
+Result<int, std::string> hand_string(int x) {
+  auto r = step_string(x);
+  if (r.is_err()) [[unlikely]] {
+    return Err(std::move(r).unwrap_err_unchecked());
+  }
+  int v = std::move(r).unwrap_unchecked();
+  return Ok(v + 1);
+}
+Result<int, std::string> try_string(int x) { return Ok(NAVP_TRY(step_string(x)) + 1); }
+Result<int, std::string> try_assign_string(int x) {
+  NAVP_TRY_ASSIGN(int v, step_string(x));
+  return Ok(v + 1);
+}
+
+Option<int> hand_option(int x) {
+  auto op = step_option(x);
+  if (op.is_none()) [[unlikely]] {
+    return None;
+  }
+  int v = std::move(op).unwrap_unchecked();
+  return v + 1;
+}
+Option<int> try_option(int x) { return NAVP_TRY(step_option(x)) + 1; }
+Option<int> try_assign_option(int x) {
+  NAVP_TRY_ASSIGN(int v, step_option(x));
+  return v + 1;
+}
+
+Result<int, int> hand_discard(int x) {
+  if (auto r = step(x); r.is_err()) [[unlikely]] {
+    return Err(std::move(r).unwrap_err_unchecked());
+  }
+  return Ok(x);
+}
+Result<int, int> try_discard(int x) {
+  NAVP_TRY_DISCARD(step(x));
+  return Ok(x);
+}
+}
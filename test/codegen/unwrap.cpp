@@ -0,0 +1,22 @@
+// Functions compared by check.sh, each one is a single unwrap-like call site.
+#include <optional>
+
+#include "option.hpp"
+#include "result.hpp"
+
+extern "C" {
+
+int std_optional_value(const std::optional<int>& o) { return o.value(); }
+
+int navp_option_unwrap(const navp::Option<int>& o) { return o.unwrap(); }
+
+int navp_option_expect(const navp::Option<int>& o) { return o.expect("expect a none option"); }
+
+int* navp_option_ptr_unwrap(const navp::Option<int*>& o) { return o.unwrap(); }
+
+int navp_result_unwrap(const navp::Result<int, int>& r) { return r.unwrap(); }
+
+int navp_result_expect(const navp::Result<int, int>& r) { return r.expect("expect an err result"); }
+
+int navp_result_unwrap_err(const navp::Result<int, int>& r) { return r.unwrap_err(); }
+}
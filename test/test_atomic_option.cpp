@@ -0,0 +1,110 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../src/atomic_option.hpp"
+#include "doctest.h"
+
+using navp::AtomicOption;
+using navp::None;
+using navp::Option;
+using navp::Some;
+
+enum class Slot : std::uint16_t { A, B, Invalid = 0xFFFF };
+
+template <>
+struct navp::niche_traits<Slot> : navp::sentinel_niche<Slot, Slot::Invalid> {};
+
+struct Pair {
+  std::uint64_t lo;
+  std::uint64_t hi;
+  bool operator==(const Pair&) const = default;
+};
+
+// hi == 0 is None
+template <>
+struct navp::niche_traits<Pair> {
+  static constexpr Pair none() noexcept { return {0, 0}; }
+  static constexpr bool is_none(const Pair& val) noexcept { return val.hi == 0; }
+};
+
+TEST_CASE("Atomic Option") {
+  static_assert(sizeof(AtomicOption<int*>) == sizeof(int*));
+  static_assert(sizeof(AtomicOption<Slot>) == sizeof(Slot));
+  static_assert(sizeof(AtomicOption<std::uint32_t>) == 8);
+  static_assert(sizeof(AtomicOption<std::uint64_t>) == 16);
+  static_assert(sizeof(AtomicOption<Pair>) == 16);
+  static_assert(AtomicOption<int*>::is_always_lock_free);
+  static_assert(AtomicOption<std::uint32_t>::is_always_lock_free);
+
+  int x = 1;
+  AtomicOption<int*> p;
+  CHECK(p.load().is_none());
+  CHECK(p.put(&x));
+  CHECK(!p.put(nullptr));
+  CHECK(p.load() == Some(&x));
+  CHECK(p.take() == Some(&x));
+  CHECK(p.take().is_none());
+  // the niche value would read back as None, it is not put
+  CHECK(!p.put(nullptr));
+  CHECK(p.load().is_none());
+  CHECK(!AtomicOption<Slot>().put(Slot::Invalid));
+
+  AtomicOption<std::uint32_t> u(Some(std::uint32_t(0)));
+  CHECK(u.load() == Some(std::uint32_t(0)));
+  CHECK(u.swap(None) == Some(std::uint32_t(0)));
+  CHECK(u.load().is_none());
+  u.store(Some(std::uint32_t(0xFFFFFFFF)));
+  CHECK(u.load() == Some(std::uint32_t(0xFFFFFFFF)));
+
+  AtomicOption<Slot> s;
+  Option<Slot> expected = Some(Slot::A);
+  CHECK(!s.compare_exchange(expected, Some(Slot::B)));
+  CHECK(expected.is_none());
+  CHECK(s.compare_exchange(expected, Some(Slot::B)));
+  CHECK(s.load() == Some(Slot::B));
+
+  AtomicOption<std::uint64_t> w;
+  CHECK(w.put(0));
+  CHECK(!w.put(7));
+  CHECK(w.take() == Some(std::uint64_t(0)));
+
+  AtomicOption<double> d;
+  CHECK(d.put(-0.0));
+  Option<double> zero = Some(0.0);
+  // compared bitwise, 0.0 is not -0.0
+  CHECK(!d.compare_exchange(zero, None));
+  CHECK(d.compare_exchange(zero, None));
+  CHECK(d.load().is_none());
+
+  AtomicOption<Pair> q;
+  CHECK(q.put(Pair{1, 2}));
+  Option<Pair> cur = q.load();
+  CHECK(q.compare_exchange(cur, Some(Pair{3, 4})));
+  CHECK(q.take() == Some(Pair{3, 4}));
+}
+
+TEST_CASE("Atomic Option Hand Off") {
+  constexpr std::uint64_t n = 20000;
+  AtomicOption<std::uint64_t> slot;
+  std::uint64_t sum = 0;
+  std::jthread consumer([&]() {
+    for (std::uint64_t received = 0; received < n;) {
+      if (auto v = slot.take(std::memory_order_acquire)) {
+        sum += v.unwrap();
+        ++received;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for (std::uint64_t i = 1; i <= n; ++i) {
+    while (!slot.put(i, std::memory_order_release)) {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+  CHECK(sum == n * (n + 1) / 2);
+  CHECK(slot.load().is_none());
+}
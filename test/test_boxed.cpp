@@ -0,0 +1,88 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "../src/boxed.hpp"
+#include "../src/result.hpp"
+#include "doctest.h"
+
+using navp::Boxed;
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+
+struct BigError {
+  int line = 0;
+  std::string file;
+  std::array<char, 128> detail{};
+  bool operator==(const BigError&) const = default;
+};
+
+static Result<int, Boxed<BigError>> check(int x) {
+  if (x < 0) {
+    return Err(BigError{7, "check.cpp", {}});
+  }
+  return Ok(x);
+}
+
+TEST_CASE("Boxed") {
+  static_assert(sizeof(Result<int, Boxed<BigError>>) == 2 * sizeof(void*));
+  static_assert(sizeof(Result<int, BigError>) > sizeof(BigError));
+  static_assert(std::is_same_v<navp::thin_error_t<BigError>, Boxed<BigError>>);
+  static_assert(std::is_same_v<navp::thin_error_t<int>, int>);
+  static_assert(std::is_same_v<navp::thin_error_t<std::array<char, 17>>, Boxed<std::array<char, 17>>>);
+
+  CHECK(check(3).unwrap() == 3);
+  auto r = check(-1);
+  REQUIRE(r.is_err());
+  CHECK(r.unwrap_err()->line == 7);
+  CHECK((*r.unwrap_err()).file == "check.cpp");
+
+  SUBCASE("copy and move") {
+    auto copy = r;
+    CHECK(copy.unwrap_err()->file == "check.cpp");
+    CHECK(copy.unwrap_err().get() != r.unwrap_err().get());
+    CHECK(copy.unwrap_err() == r.unwrap_err());
+
+    auto moved = std::move(copy);
+    CHECK(moved.unwrap_err()->line == 7);
+
+    Boxed<BigError> a(BigError{1, "a", {}});
+    Boxed<BigError> b(std::in_place, 2, "b");
+    a = b;
+    CHECK(a->file == "b");
+    b = Boxed<BigError>(BigError{3, "c", {}});
+    CHECK(b->line == 3);
+    a = std::move(b);
+    CHECK(a->line == 3);
+
+    // moved-from boxes are empty, they compare equal to each other and to no error
+    Boxed<BigError> c(std::move(a));
+    CHECK(a.get() == nullptr);
+    CHECK(a == b);
+    CHECK(!(a == c));
+    CHECK(!(c == a));
+  }
+
+  SUBCASE("pool reuse") {
+    const void* first = nullptr;
+    {
+      Boxed<BigError> a(BigError{});
+      first = a.get();
+    }
+    Boxed<BigError> b(BigError{});
+    CHECK(b.get() == first);
+  }
+
+  SUBCASE("other threads") {
+    // boxes freed on another thread go to that thread's list, which is emptied when it exits
+    Boxed<BigError> a(BigError{4, "main", {}});
+    std::jthread([&] {
+      Boxed<BigError> local(BigError{5, "worker", {}});
+      a = std::move(local);
+    }).join();
+    CHECK(a->file == "worker");
+  }
+}
@@ -0,0 +1,134 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <list>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../src/collect.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+// counts copies so tests can tell moved elements from copied ones
+struct Tracked {
+  static inline int copies = 0;
+  int v = 0;
+  Tracked() = default;
+  Tracked(int v) : v(v) {}
+  Tracked(const Tracked& other) : v(other.v) { ++copies; }
+  Tracked(Tracked&&) noexcept = default;
+  Tracked& operator=(const Tracked& other) {
+    v = other.v;
+    ++copies;
+    return *this;
+  }
+  Tracked& operator=(Tracked&&) noexcept = default;
+};
+
+using result_t = Result<Tracked, std::string>;
+
+static std::vector<result_t> make_results(int n, int err_at) {
+  std::vector<result_t> out;
+  for (int i = 0; i < n; ++i) {
+    if (i == err_at) {
+      out.emplace_back(Err(std::to_string(i)));
+    } else {
+      out.emplace_back(Ok(Tracked(i)));
+    }
+  }
+  return out;
+}
+
+TEST_CASE("Collect Result") {
+  auto results = make_results(5, -1);
+  Tracked::copies = 0;
+  auto copied = navp::collect(results);
+  CHECK_EQ(Tracked::copies, 5);
+  REQUIRE(copied.is_ok());
+  CHECK_EQ(copied.unwrap().size(), 5);
+  CHECK_EQ(copied.unwrap()[4].v, 4);
+
+  Tracked::copies = 0;
+  auto moved = navp::collect(std::move(results));
+  CHECK_EQ(Tracked::copies, 0);
+  CHECK_EQ(moved.unwrap()[2].v, 2);
+
+  auto failed = navp::collect(make_results(5, 3));
+  REQUIRE(failed.is_err());
+  CHECK_EQ(failed.unwrap_err(), "3");
+
+  // prvalue elements are moved
+  Tracked::copies = 0;
+  auto view = std::views::iota(0, 4) | std::views::transform([](int i) { return result_t(Ok(Tracked(i))); });
+  CHECK_EQ(navp::collect(view).unwrap().size(), 4);
+  CHECK_EQ(Tracked::copies, 0);
+
+  // an rvalue view over an lvalue container must not move from it
+  auto kept = make_results(3, -1);
+  Tracked::copies = 0;
+  navp::collect(std::views::all(kept));
+  CHECK_EQ(Tracked::copies, 3);
+}
+
+TEST_CASE("Collect Option") {
+  std::list<Option<int>> all{Some(1), Some(2), Some(3)};
+  CHECK_EQ(navp::collect(all), Some(std::vector<int>{1, 2, 3}));
+
+  std::vector<Option<int>> holes{Some(1), None, Some(3)};
+  CHECK_EQ(navp::collect(holes), None);
+  CHECK_EQ(navp::collect(std::vector<Option<int>>{}), Some(std::vector<int>{}));
+}
+
+TEST_CASE("Partition") {
+  auto results = make_results(6, 2);
+  results[4] = Err(std::string("4"));
+  Tracked::copies = 0;
+  auto [oks, errs] = navp::partition_results(std::move(results));
+  CHECK_EQ(Tracked::copies, 0);
+  CHECK_EQ(oks.size(), 4);
+  CHECK_EQ(oks.capacity(), 4);
+  CHECK_EQ(errs, std::vector<std::string>{"2", "4"});
+  CHECK_EQ(errs.capacity(), 2);
+
+  // a transform view is read once, the projection runs once per element
+  int calls = 0;
+  auto odd_fails = std::views::iota(0, 10) | std::views::transform([&](int i) -> Result<int, int> {
+                     ++calls;
+                     return i % 2 == 0 ? Result<int, int>(Ok(i)) : Result<int, int>(Err(i));
+                   });
+  auto [evens, odds] = navp::partition_results(odd_fails);
+  CHECK_EQ(calls, 10);
+  CHECK_EQ(evens, std::vector<int>{0, 2, 4, 6, 8});
+  CHECK_EQ(odds, std::vector<int>{1, 3, 5, 7, 9});
+
+  std::vector<Option<std::string>> ops{Some(std::string("a")), None, None, Some(std::string("d"))};
+  auto [somes, nones] = navp::partition_options(ops);
+  CHECK_EQ(somes, std::vector<std::string>{"a", "d"});
+  CHECK_EQ(nones, std::vector<std::size_t>{1, 2});
+  // copied from an lvalue range
+  CHECK_EQ(ops[0], Some(std::string("a")));
+}
+
+TEST_CASE("Transpose") {
+  using op_res = Option<Result<int, std::string>>;
+  using res_op = Result<Option<int>, std::string>;
+
+  auto none = navp::transpose(op_res(None));
+  CHECK(none.is_ok());
+  CHECK_EQ(none.unwrap(), None);
+
+  auto some_ok = navp::transpose(op_res(Some(Result<int, std::string>(Ok(5)))));
+  CHECK_EQ(some_ok.unwrap(), Some(5));
+
+  auto some_err = navp::transpose(op_res(Some(Result<int, std::string>(Err(std::string("e"))))));
+  CHECK_EQ(some_err.unwrap_err(), "e");
+
+  CHECK_EQ(navp::transpose(res_op(Ok(Option<int>(None)))), None);
+  CHECK_EQ(navp::transpose(res_op(Ok(Some(7)))).unwrap().unwrap(), 7);
+  CHECK_EQ(navp::transpose(res_op(Err(std::string("f")))).unwrap().unwrap_err(), "f");
+}
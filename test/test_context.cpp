@@ -0,0 +1,145 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "../src/context.hpp"
+#include "../src/error_code.hpp"
+#include "doctest.h"
+
+using navp::ContextError;
+using navp::Err;
+using navp::ErrorCode;
+using navp::Ok;
+using navp::Result;
+
+constexpr const char* parse_messages[] = {"not a number"};
+static const navp::error_domain parse_errors("parse", parse_messages);
+
+static Result<int, ErrorCode> parse(std::string_view s) {
+  int v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size()) {
+    return Err(parse_errors(0));
+  }
+  return Ok(v);
+}
+
+static Result<int, ContextError<ErrorCode>> parse_epoch(std::string_view s, int epoch) {
+  return parse(s).context("while parsing epoch {}", epoch);
+}
+
+static Result<int, ContextError<ErrorCode>> load(std::string file, std::string_view s) {
+  return parse_epoch(s, 3).context("while loading {} ({} bytes, ok={})", file, s.size(), false);
+}
+
+TEST_CASE("Context") {
+  CHECK(parse_epoch("12", 1).unwrap() == 12);
+
+  auto r = load("config.txt", "x");
+  REQUIRE(r.is_err());
+  const auto& err = r.unwrap_err();
+  CHECK(err.root() == parse_errors(0));
+  CHECK(err.depth() == 2);
+  CHECK(err.to_string() == "while loading config.txt (1 bytes, ok=false): while parsing epoch 3: parse: not a number");
+  CHECK(err.contexts() == std::vector<std::string>{"while loading config.txt (1 bytes, ok=false)",
+                                                   "while parsing epoch 3"});
+
+  SUBCASE("plain error and escapes") {
+    Result<void, std::string> bad = Err(std::string("disk full"));
+    auto c = std::move(bad).context("{{step}} {} of {}", 2, 7.5);
+    CHECK(c.unwrap_err().to_string() == "{step} 2 of 7.5: disk full");
+
+    Result<void, std::string> good = Ok();
+    CHECK(std::move(good).context("never formatted {}", 1).is_ok());
+  }
+
+  SUBCASE("copies share the chain") {
+    auto copy = r;
+    r = Err(ContextError<ErrorCode>(parse_errors(0)));
+    CHECK(copy.unwrap_err().depth() == 2);
+    CHECK(r.unwrap_err().depth() == 0);
+    CHECK(copy.unwrap_err().to_string() ==
+          "while loading config.txt (1 bytes, ok=false): while parsing epoch 3: parse: not a number");
+  }
+
+  SUBCASE("arguments are captured") {
+    std::string name = "temp";
+    auto e = ContextError<std::string>(std::string("root")).context("name={}", name);
+    name = "changed";
+    CHECK(e.to_string() == "name=temp: root");
+  }
+}
+
+// has to_string() but no default constructor or assignment
+struct Point {
+  Point(int px, int py) : x(px), y(py) {}
+  Point(const Point&) = default;
+  Point& operator=(const Point&) = delete;
+  std::string to_string() const { return "(" + std::to_string(x) + ", " + std::to_string(y) + ")"; }
+  int x;
+  int y;
+};
+
+struct ThrowingCopy {
+  ThrowingCopy() = default;
+  ThrowingCopy(const ThrowingCopy&) { throw std::runtime_error("copy"); }
+  std::string to_string() const { return "never"; }
+};
+
+TEST_CASE("Context Captures") {
+  auto e = ContextError<int>(1).context("at {}", Point(2, 3));
+  CHECK(e.to_string() == "at (2, 3): 1");
+
+  navp::context_arena arena;
+  ContextError<int> err(1);
+  const ThrowingCopy bad;
+  CHECK_THROWS_AS(err.context("{}", bad), std::runtime_error);
+  CHECK(err.depth() == 0);
+  // the failed node is not counted, the arena still rewinds
+  CHECK(arena.live() == 0);
+}
+
+TEST_CASE("Context Arena") {
+  SUBCASE("request arena") {
+    navp::context_arena arena(256);
+    CHECK(&navp::context_arena::current() == &arena);
+    {
+      auto r = load("a", "?");
+      CHECK(arena.live() == 2);
+      // moving the error to another thread and dropping it there releases the links
+      std::jthread([e = std::move(r).unwrap_err()] { CHECK(e.depth() == 2); }).join();
+      CHECK(arena.live() == 0);
+    }
+    // a long chain spills into more chunks
+    ContextError<int> deep(1);
+    for (int i = 0; i < 100; ++i) {
+      deep.context("level {} {}", i, std::string(40, 'x'));
+    }
+    CHECK(deep.depth() == 100);
+    CHECK(arena.live() == 100);
+    CHECK(deep.contexts().back() == "level 0 " + std::string(40, 'x'));
+  }
+
+  SUBCASE("chain outlives its thread") {
+    // the worker's default arena dies with the thread, the chunks stay with the links
+    ContextError<int> e(0);
+    std::jthread([&e] { e = ContextError<int>(1).context("on worker {}", std::string(100, 'w')); }).join();
+    CHECK(e.depth() == 1);
+    CHECK(e.to_string() == "on worker " + std::string(100, 'w') + ": 1");
+    e = ContextError<int>(2);
+    CHECK(e.depth() == 0);
+  }
+
+  SUBCASE("default arena") {
+    auto& arena = navp::context_arena::current();
+    const auto before = arena.live();
+    {
+      auto r = load("b", "?");
+      CHECK(arena.live() == before + 2);
+    }
+    CHECK(arena.live() == before);
+  }
+}
@@ -0,0 +1,172 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../src/coroutine.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+using parsed_t = Result<int, std::string>;
+
+static parsed_t parse(std::string_view s) {
+  int v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size()) {
+    return Err("not a number: " + std::string(s));
+  }
+  return Ok(v);
+}
+
+static int destroyed = 0;
+struct Guard {
+  ~Guard() { ++destroyed; }
+};
+
+static parsed_t sum(std::string_view a, std::string_view b) {
+  Guard guard;
+  int x = co_await parse(a);
+  int y = co_await parse(b);
+  co_return x + y;
+}
+
+static parsed_t nested(std::string_view a, std::string_view b, std::string_view c) {
+  int ab = co_await sum(a, b);
+  co_return ab * co_await parse(c);
+}
+
+static Result<void, std::string> check_positive(int x) {
+  if (x <= 0) {
+    co_return Err(std::string("not positive"));
+  }
+  co_await Result<void, std::string>(Ok());
+  co_return Ok();
+}
+
+static Result<std::unique_ptr<int>, std::string> boxed(std::string_view s) {
+  auto v = co_await parse(s);
+  co_await check_positive(v);
+  co_return std::make_unique<int>(v);
+}
+
+TEST_CASE("Result") {
+  destroyed = 0;
+  CHECK_EQ(sum("1", "2").unwrap(), 3);
+  CHECK_EQ(sum("x", "2").unwrap_err(), "not a number: x");
+  CHECK_EQ(sum("1", "y").unwrap_err(), "not a number: y");
+  // the frame is destroyed on both the normal and the early return
+  CHECK_EQ(destroyed, 3);
+
+  CHECK_EQ(nested("1", "2", "3").unwrap(), 9);
+  CHECK_EQ(nested("1", "b", "3").unwrap_err(), "not a number: b");
+  CHECK_EQ(nested("1", "2", "c").unwrap_err(), "not a number: c");
+
+  CHECK(check_positive(1).is_ok());
+  CHECK_EQ(check_positive(0).unwrap_err(), "not positive");
+  CHECK_EQ(*boxed("5").unwrap(), 5);
+  CHECK_EQ(boxed("-5").unwrap_err(), "not positive");
+}
+
+TEST_CASE("Lvalue Operand") {
+  auto r = parse("4");
+  auto copy = [&]() -> parsed_t {
+    int x = co_await r;
+    co_return x;
+  };
+  CHECK_EQ(copy().unwrap(), 4);
+  CHECK_EQ(r.unwrap(), 4);
+
+  Result<std::string, std::string> err = Err(std::string("kept"));
+  auto fail = [&]() -> Result<int, std::string> {
+    co_await err;
+    co_return 0;
+  };
+  CHECK_EQ(fail().unwrap_err(), "kept");
+  CHECK_EQ(err.unwrap_err(), "kept");
+}
+
+static Option<int> half(int x) {
+  if (x % 2 != 0) {
+    return None;
+  }
+  return Some(x / 2);
+}
+
+static Option<int> quarter(int x) {
+  int h = co_await half(x);
+  co_return co_await half(h);
+}
+
+TEST_CASE("Option") {
+  // a conversion failure panics with the error type of the coroutine's return type
+  static_assert(std::is_same_v<navp::details::coroutine_error_t<Option<int>>, navp::option_error>);
+  static_assert(std::is_same_v<navp::details::coroutine_error_t<parsed_t>, navp::result_error>);
+  CHECK_EQ(quarter(8), Some(2));
+  CHECK_EQ(quarter(6), None);
+  CHECK_EQ(quarter(5), None);
+}
+
+TEST_CASE("Arena") {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  {
+    navp::coroutine_arena arena(buffer);
+    CHECK_EQ(navp::coroutine_arena::current(), &arena);
+    CHECK_EQ(nested("2", "3", "4").unwrap(), 20);
+    CHECK_EQ(nested("2", "x", "4").unwrap_err(), "not a number: x");
+    // every frame was returned
+    CHECK_EQ(arena.used(), 0);
+  }
+  CHECK_NE(navp::coroutine_arena::current(), nullptr);
+
+  // a frame freed out of LIFO order is not reclaimed, not even once the frames above it are gone
+  {
+    navp::coroutine_arena arena(buffer);
+    void* below = arena.allocate(64);
+    void* above = arena.allocate(64);
+    CHECK(arena.deallocate(below, 64));
+    CHECK(arena.deallocate(above, 64));
+    CHECK_EQ(arena.used(), 64);
+  }
+
+  // frames that do not fit fall back to the heap
+  std::byte tiny[16];
+  navp::coroutine_arena arena(tiny);
+  CHECK_EQ(sum("1", "1").unwrap(), 2);
+  CHECK_EQ(arena.used(), 0);
+}
+
+TEST_CASE("Unaligned Arena") {
+  constexpr std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  alignas(align) std::byte raw[4096];
+  navp::coroutine_arena arena(std::span<std::byte>(raw + 1, sizeof(raw) - 1));
+  void* p = arena.allocate(24);
+  REQUIRE(p != nullptr);
+  CHECK(reinterpret_cast<std::uintptr_t>(p) % align == 0);
+  CHECK(arena.deallocate(p, 24));
+  CHECK_EQ(sum("2", "3").unwrap(), 5);
+  CHECK_EQ(arena.used(), 0);
+
+  // too small to reach the first boundary
+  navp::coroutine_arena none(std::span<std::byte>(raw + 1, 2));
+  CHECK(none.allocate(1) == nullptr);
+}
+
+TEST_CASE("Exception") {
+  auto thrower = []() -> parsed_t {
+    co_await parse("1");
+    throw std::runtime_error("thrown");
+    co_return 0;
+  };
+  CHECK_THROWS_AS(thrower(), std::runtime_error);
+}
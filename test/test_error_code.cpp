@@ -0,0 +1,79 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../src/error_code.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::ErrorCode;
+using navp::Ok;
+using navp::Result;
+
+enum class parse_errc : std::uint16_t { empty, not_a_number };
+constexpr const char* parse_messages[] = {"empty input", "not a number"};
+static const navp::error_domain parse_errors("parse", parse_messages);
+
+constexpr const char* io_messages[] = {"not found", "timed out"};
+static const navp::error_domain io_errors("io", io_messages);
+
+static Result<double, ErrorCode> parse(std::string_view s) {
+  if (s.empty()) {
+    return Err(parse_errors(parse_errc::empty));
+  }
+  double v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size()) {
+    return Err(parse_errors(parse_errc::not_a_number));
+  }
+  return Ok(v);
+}
+
+TEST_CASE("ErrorCode") {
+  static_assert(sizeof(Result<double, ErrorCode>) == 16);
+  static_assert(std::is_trivially_copyable_v<Result<double, ErrorCode>>);
+
+  CHECK(parse("1.5").unwrap() == 1.5);
+  auto err = parse("x").unwrap_err();
+  CHECK(err == parse_errors(parse_errc::not_a_number));
+  CHECK(err != io_errors(1));
+  CHECK(err.domain() == parse_errors.id());
+  CHECK(err.code() == 1);
+  CHECK(std::string_view(err.message()) == "not a number");
+  CHECK(std::string_view(err.domain_name()) == "parse");
+  CHECK(err.to_string() == "parse: not a number");
+  CHECK(parse("").unwrap_err().to_string() == "parse: empty input");
+  CHECK(io_errors(1).to_string() == "io: timed out");
+
+  CHECK(ErrorCode::from_raw(err.raw()) == err);
+  CHECK(parse_errors.id() != io_errors.id());
+
+  SUBCASE("unknown") {
+    CHECK(ErrorCode().to_string() == "unknown: unknown error");
+    CHECK(parse_errors(7).to_string() == "parse: unknown error");
+    CHECK(ErrorCode(60000, 0).to_string() == "unknown: unknown error");
+  }
+}
+
+TEST_CASE("ErrorCode Concurrent Registration") {
+  constexpr int threads = 8;
+  constexpr const char* messages[] = {"m"};
+  std::vector<std::unique_ptr<navp::error_domain>> domains(threads);
+  {
+    std::vector<std::jthread> pool;
+    for (int t = 0; t < threads; ++t) {
+      pool.emplace_back([&, t] { domains[t] = std::make_unique<navp::error_domain>("concurrent", messages); });
+    }
+  }
+  std::set<ErrorCode::domain_type> ids;
+  for (auto& d : domains) {
+    ids.insert(d->id());
+    CHECK((*d)(0).to_string() == "concurrent: m");
+  }
+  CHECK(ids.size() == threads);
+}
@@ -0,0 +1,125 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/executor.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+using navp::TaskExecutor;
+
+using result_t = Result<int, std::string>;
+
+TEST_CASE("Run Indexed") {
+  TaskExecutor exec(4);
+  CHECK_EQ(exec.threads(), 4);
+
+  auto out = exec.run_indexed(10000, [](std::size_t i) -> result_t {
+    if (i % 1000 == 999) {
+      return Err("bad " + std::to_string(i));
+    }
+    return Ok(static_cast<int>(i) * 2);
+  });
+  REQUIRE_EQ(out.size(), 10000);
+  CHECK_EQ(out.count_err(), 10);
+  CHECK_EQ(out.ok_unchecked(500), 1000);
+  // every error is kept, sorted by task index
+  auto errs = out.errors();
+  for (std::size_t k = 0; k < errs.size(); ++k) {
+    CHECK_EQ(errs[k].first, k * 1000 + 999);
+    CHECK_EQ(errs[k].second, "bad " + std::to_string(k * 1000 + 999));
+  }
+
+  auto none = exec.run_indexed(0, [](std::size_t) -> result_t { return Ok(0); });
+  CHECK(none.empty());
+}
+
+TEST_CASE("All Errors") {
+  // errors from every thread at once
+  auto out = TaskExecutor(8).run_indexed(50000, [](std::size_t i) -> result_t { return Err(std::to_string(i)); });
+  REQUIRE_EQ(out.count_err(), 50000);
+  CHECK_EQ(out.count_ok(), 0);
+  CHECK_EQ(out.err_unchecked(49999), "49999");
+}
+
+TEST_CASE("Stealing") {
+  // all the slow tasks are in the first worker's initial range, the others must steal them
+  std::atomic<int> threads_seen{0};
+  std::vector<std::atomic<bool>> seen(64);
+  auto out = TaskExecutor(4).run_indexed(400, [&](std::size_t i) -> result_t {
+    if (i < 100) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    const auto slot = std::hash<std::thread::id>{}(std::this_thread::get_id()) % seen.size();
+    if (i < 100 && !seen[slot].exchange(true)) {
+      threads_seen.fetch_add(1);
+    }
+    return Ok(static_cast<int>(i));
+  });
+  CHECK_EQ(out.count_ok(), 400);
+  CHECK_GT(threads_seen.load(), 1);
+}
+
+TEST_CASE("Run All") {
+  std::vector<std::function<result_t()>> tasks;
+  for (int i = 0; i < 100; ++i) {
+    tasks.emplace_back([i]() -> result_t {
+      if (i == 42) {
+        return Err(std::string("42"));
+      }
+      return Ok(i);
+    });
+  }
+  auto out = TaskExecutor().run_all(tasks);
+  CHECK_EQ(out.size(), 100);
+  CHECK(out.is_err(42));
+  CHECK_EQ(out[99].unwrap(), 99);
+
+  CHECK_THROWS_AS(TaskExecutor(2).run_indexed(100,
+                                              [](std::size_t i) -> result_t {
+                                                if (i == 50) {
+                                                  throw std::runtime_error("task");
+                                                }
+                                                return Ok(0);
+                                              }),
+                  std::runtime_error);
+}
+
+TEST_CASE("Status Tasks") {
+  // validations return Result<void, E>: only the failures come back, sorted by index
+  auto failures = TaskExecutor(4).run_indexed(5000, [](std::size_t i) -> Result<void, std::string> {
+    if (i % 1000 == 7) {
+      return Err("invalid " + std::to_string(i));
+    }
+    return Ok();
+  });
+  static_assert(std::is_same_v<decltype(failures), std::vector<std::pair<std::size_t, std::string>>>);
+  REQUIRE_EQ(failures.size(), 5);
+  for (std::size_t k = 0; k < failures.size(); ++k) {
+    CHECK_EQ(failures[k].first, k * 1000 + 7);
+    CHECK_EQ(failures[k].second, "invalid " + std::to_string(k * 1000 + 7));
+  }
+  CHECK(TaskExecutor(2).run_indexed(3, [](std::size_t) -> Result<void, int> { return Ok(); }).empty());
+
+  // bool results keep one byte per task, so neighbouring tasks can be written from different threads
+  auto flags = TaskExecutor(4).run_indexed(10000, [](std::size_t i) -> Result<bool, int> {
+    if (i == 4321) {
+      return Err(-1);
+    }
+    return Ok(i % 3 == 0);
+  });
+  REQUIRE_EQ(flags.size(), 10000);
+  CHECK_EQ(flags.count_err(), 1);
+  CHECK(flags.is_err(4321));
+  for (std::size_t i = 0; i < flags.size(); ++i) {
+    if (i != 4321) {
+      REQUIRE_EQ(flags.ok_unchecked(i), i % 3 == 0);
+    }
+  }
+}
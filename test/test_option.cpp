@@ -1,7 +1,12 @@
 #include <cassert>
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define NAVP_EAGER_TRACE
 
+#include <climits>
+#include <cstdlib>
+#include <new>
 #include <optional>
+#include <string_view>
 
 #include "../src/option.hpp"
 #include "doctest.h"
@@ -10,6 +15,31 @@ using navp::None;
 using navp::Option;
 using navp::Some;
 
+// counts the global allocations made by this thread, the default operator delete frees with std::free
+static thread_local std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) {
+  ++g_allocations;
+  if (void* p = std::malloc(n == 0 ? 1 : n)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+enum class Color { Red, Green, Blue, Invalid };
+
+template <>
+struct navp::niche_traits<Color> : navp::sentinel_niche<Color, Color::Invalid> {};
+template <>
+struct navp::niche_traits<long long> : navp::sentinel_niche<long long, LLONG_MIN> {};
+template <>
+struct navp::niche_traits<float> : navp::nan_niche<float> {};
+template <>
+struct navp::niche_traits<std::string_view> {
+  static constexpr std::string_view none() noexcept { return {}; }
+  static constexpr bool is_none(std::string_view val) noexcept { return val.data() == nullptr; }
+};
+
 // from [https://github.com/TartanLlama/optional/tree/master/tests]
 TEST_CASE("Triviality") {
   static_assert(!std::is_trivially_constructible_v<Option<int>>);
@@ -67,6 +97,65 @@ TEST_CASE("Size") {
   };
   static_assert(sizeof(Option<ComplexT>) == sizeof(ComplexT) + alignof(ComplexT));
   static_assert(sizeof(Option<ComplexT>) == sizeof(std::optional<ComplexT>));
+
+  // nullptr is used as None
+  static_assert(sizeof(Option<int*>) == sizeof(int*));
+  static_assert(sizeof(Option<const ComplexT*>) == sizeof(const ComplexT*));
+  static_assert(sizeof(Option<std::reference_wrapper<ComplexT>>) == sizeof(ComplexT*));
+  static_assert(std::is_trivially_copyable_v<Option<int*>>);
+  static_assert(std::is_trivially_copyable_v<Option<std::reference_wrapper<ComplexT>>>);
+}
+
+TEST_CASE("Niche") {
+  int i = 42;
+  Option<int*> o1;
+  CHECK(o1.is_none());
+  o1 = &i;
+  CHECK(o1.is_some());
+  CHECK(*o1.unwrap() == 42);
+  o1 = None;
+  CHECK(o1.is_none());
+
+  constexpr Option<const int*> o2 = None;
+  static_assert(o2.is_none());
+
+  auto o3 = Some<std::string>("Hello niche!");
+  auto ref = o3.as_ref();
+  CHECK(ref.is_some());
+  CHECK(ref.unwrap().get() == "Hello niche!");
+  o3 = None;
+  CHECK(o3.as_ref().is_none());
+}
+
+TEST_CASE("Niche Traits") {
+  static_assert(sizeof(Option<Color>) == sizeof(Color));
+  static_assert(sizeof(Option<long long>) == sizeof(long long));
+  static_assert(sizeof(Option<float>) == sizeof(float));
+  static_assert(sizeof(Option<std::string_view>) == sizeof(std::string_view));
+  static_assert(std::is_trivially_copyable_v<Option<float>>);
+
+  constexpr Option<Color> c1 = Color::Green;
+  constexpr Option<Color> c2 = None;
+  static_assert(c1.is_some() && c2.is_none());
+  CHECK(c1.unwrap() == Color::Green);
+
+  Option<long long> i1 = 10ll;
+  CHECK(i1.unwrap() == 10);
+  i1 = None;
+  CHECK(i1.is_none());
+  CHECK(i1.unwrap_or(20ll) == 20);
+
+  Option<float> f1 = 1.5f;
+  CHECK(f1.unwrap() == 1.5f);
+  f1 = None;
+  CHECK(f1.is_none());
+  CHECK_THROWS(f1.unwrap());
+
+  Option<std::string_view> s1 = std::string_view("");
+  CHECK(s1.is_some());
+  CHECK(s1.unwrap().empty());
+  s1 = None;
+  CHECK(s1.is_none());
 }
 
 // from [https://github.com/TartanLlama/optional/tree/master/tests]
@@ -371,4 +460,96 @@ TEST_CASE("Nesting") {
   CHECK(x.unwrap().unwrap() == 10);
   x = None;
   CHECK_THROWS(x.unwrap());
-}
\ No newline at end of file
+}
+TEST_CASE("Trace") {
+  Option<int> o1 = None;
+  try {
+    o1.expect("expect a none option");
+    FAIL("expect should throw");
+  } catch (const navp::option_error& e) {
+    CHECK(std::string(e.what()) == "expect a none option");
+    // the trace was printed eagerly, nothing is kept in the error
+    CHECK(e.raw_trace().empty());
+  }
+}
+
+TEST_CASE("Trace Dedup") {
+  auto failures = []() {
+    std::uint64_t total = 0;
+    navp::for_each_panic_site([&](const char*, std::uint32_t, std::uint64_t n) { total += n; });
+    return total;
+  };
+  const auto before = failures();
+  std::size_t sites_before = 0;
+  navp::for_each_panic_site([&](const char*, std::uint32_t, std::uint64_t) { ++sites_before; });
+
+  Option<int> o1 = None;
+  for (int i = 0; i < 10; ++i) {
+    CHECK_THROWS(o1.expect("the same call site"));
+  }
+  CHECK(failures() == before + 10);
+  std::size_t sites_after = 0;
+  navp::for_each_panic_site([&](const char*, std::uint32_t, std::uint64_t) { ++sites_after; });
+  CHECK(sites_after == sites_before + 1);
+
+  // another call of the same instantiation is its own site, even when expect() is not inlined
+  const auto line = std::source_location::current().line() + 1;
+  CHECK_THROWS(o1.expect("another call site"));
+  std::uint64_t at_line = 0;
+  navp::for_each_panic_site([&](const char* file, std::uint32_t l, std::uint64_t n) {
+    if (l == line && std::string_view(file).ends_with("test_option.cpp")) {
+      at_line = n;
+    }
+  });
+  CHECK(at_line == 1);
+  CHECK(failures() == before + 11);
+}
+
+TEST_CASE("Static Message") {
+  static constexpr char literal[] = "a static message";
+  Option<int> o1 = None;
+  auto fail = [&]() {
+    try {
+      o1.expect(literal);
+    } catch (const navp::option_error& e) {
+      // the literal is not copied
+      CHECK(e.what() == literal);
+    }
+  };
+  // the first failure at a call site prints the eager trace
+  fail();
+  const auto before = g_allocations;
+  for (int i = 0; i < 3; ++i) {
+    fail();
+  }
+  CHECK(g_allocations == before);
+
+  // any other string is copied, it may die before the error
+  const std::string key = "k";
+  try {
+    o1.expect(("missing key " + key).c_str());
+    FAIL("expect should throw");
+  } catch (const std::runtime_error& e) {
+    CHECK(std::string(e.what()) == "missing key k");
+  }
+}
+
+TEST_CASE("Some Value Category") {
+  int x = 3;
+  static_assert(std::is_same_v<decltype(Some(x)), Option<int>>);
+  const std::string s = "abc";
+  static_assert(std::is_same_v<decltype(Some(s)), Option<std::string>>);
+
+  std::string moved = "moved";
+  auto op = Some(std::move(moved));
+  CHECK_EQ(op.unwrap(), "moved");
+  CHECK(moved.empty());
+
+  // assigning a value
+  Option<std::string> str;
+  str = std::string("v");
+  CHECK_EQ(str.unwrap(), "v");
+  Option<int> i;
+  i = 5;
+  CHECK_EQ(i.unwrap(), 5);
+}
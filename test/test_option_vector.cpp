@@ -0,0 +1,262 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "../src/option_vector.hpp"
+#include "../src/option_vector_simd.hpp"
+#include "doctest.h"
+
+using navp::None;
+using navp::Option;
+using navp::OptionVector;
+using navp::Some;
+
+TEST_CASE("Construct") {
+  OptionVector<double> empty;
+  CHECK(empty.empty());
+  CHECK_EQ(empty.count_some(), 0);
+
+  OptionVector<double> nones(100);
+  CHECK_EQ(nones.size(), 100);
+  CHECK_EQ(nones.count_none(), 100);
+  CHECK_EQ(nones.bitmap_words(), 2);
+
+  OptionVector<double> somes(70, 1.5);
+  CHECK_EQ(somes.count_some(), 70);
+  CHECK_EQ(somes[69], Some(1.5));
+  // bits past size() stay zero
+  CHECK_EQ(somes.bitmap()[1], (std::uint64_t{1} << 6) - 1);
+
+  OptionVector<int> list{Some(1), None, Some(3)};
+  CHECK_EQ(list.size(), 3);
+  CHECK_EQ(list[0], Some(1));
+  CHECK_EQ(list[1], None);
+  CHECK_EQ(list[2], Some(3));
+  CHECK_EQ(list.count_some(), 2);
+}
+
+TEST_CASE("Modify") {
+  OptionVector<std::string> vec;
+  for (int i = 0; i < 130; ++i) {
+    if (i % 3 == 0) {
+      vec.push_back(None);
+    } else {
+      vec.push_back(std::to_string(i));
+    }
+  }
+  CHECK_EQ(vec.size(), 130);
+  CHECK_EQ(vec.bitmap_words(), 3);
+  CHECK_EQ(vec.count_none(), 44);
+  CHECK(vec.is_none(129));
+  CHECK(vec.is_some(128));
+  CHECK_EQ(vec[128].unwrap(), "128");
+  CHECK_EQ(vec.value_unchecked(129), "");
+
+  vec.set(129, std::string("x"));
+  CHECK_EQ(vec[129], Some(std::string("x")));
+  vec.set(128, None);
+  CHECK(vec.is_none(128));
+  CHECK_EQ(vec.value_unchecked(128), "");
+  vec.set(0, Option<std::string>(Some(std::string("zero"))));
+  CHECK_EQ(vec[0].unwrap(), "zero");
+
+  vec.pop_back();
+  vec.pop_back();
+  CHECK_EQ(vec.size(), 128);
+  CHECK_EQ(vec.bitmap_words(), 2);
+
+  vec.resize(200);
+  CHECK(vec.is_none(150));
+  vec.resize(5);
+  CHECK_EQ(vec.bitmap_words(), 1);
+  CHECK_EQ(vec.count_some(), 4);
+  CHECK_EQ(vec.emplace_back(3, 'a'), "aaa");
+  CHECK_EQ(vec.count_some(), 5);
+
+  CHECK_THROWS_AS(vec.at(6), std::out_of_range);
+  vec.clear();
+  CHECK(vec.empty());
+  CHECK_EQ(vec.count_some(), 0);
+}
+
+TEST_CASE("Iterate") {
+  static_assert(std::random_access_iterator<OptionVector<int>::const_iterator>);
+
+  OptionVector<int> vec{Some(1), None, Some(3), None};
+  int sum = 0, nones = 0;
+  for (auto op : vec) {
+    if (op.is_some()) {
+      sum += op.unwrap();
+    } else {
+      ++nones;
+    }
+  }
+  CHECK_EQ(sum, 4);
+  CHECK_EQ(nones, 2);
+  CHECK_EQ(vec.end() - vec.begin(), 4);
+  CHECK_EQ(vec.begin()[2], Some(3));
+}
+
+TEST_CASE("Bool") {
+  // one byte per value, not std::vector<bool>
+  OptionVector<bool> vec;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 5 == 0) {
+      vec.push_back(None);
+    } else {
+      vec.push_back(i % 2 == 0);
+    }
+  }
+  REQUIRE_EQ(vec.size(), 100);
+  CHECK_EQ(vec.count_none(), 20);
+  CHECK_EQ(vec[4], Some(true));
+  CHECK_EQ(vec[7], Some(false));
+  CHECK_EQ(vec[10], None);
+  bool& flag = vec.value_unchecked(7);
+  flag = true;
+  CHECK_EQ(vec.values()[7], true);
+
+  auto copy = vec;
+  copy.set(4, false);
+  copy.pop_back();
+  CHECK_EQ(copy.size(), 99);
+  CHECK_EQ(copy[4], Some(false));
+  CHECK_EQ(vec[4], Some(true));
+
+  OptionVector<bool> all(OptionVector<bool>::storage_type(3, true));
+  CHECK_EQ(all.count_some(), 3);
+  CHECK_EQ(all[2], Some(true));
+}
+
+TEST_CASE("Size") {
+  // one payload plus one bit per element instead of a padded tag
+  OptionVector<double> vec(1024, 0.0);
+  const auto bytes = vec.size() * sizeof(double) + vec.bitmap_words() * sizeof(std::uint64_t);
+  CHECK_EQ(bytes, 1024 * 8 + 16 * 8);
+  CHECK_LT(bytes, 1024 * sizeof(Option<double>));
+}
+
+// integer-valued doubles keep every summation order exact
+static OptionVector<double> random_vector(std::size_t n, double density, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> value(-1000, 1000);
+  std::bernoulli_distribution some(density);
+  OptionVector<double> vec;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (some(gen)) {
+      vec.push_back(static_cast<double>(value(gen)));
+    } else {
+      vec.push_back(None);
+    }
+  }
+  return vec;
+}
+
+TEST_CASE("Bulk") {
+  OptionVector<int> ints{Some(4), None, Some(-2), Some(7), None};
+  CHECK_EQ(navp::count_some(ints), 3);
+  CHECK_EQ(navp::sum_some(ints), 9);
+  CHECK_EQ(navp::mean_some(ints), Some(3.0));
+  CHECK_EQ(navp::min_some(ints), Some(-2));
+  CHECK_EQ(navp::max_some(ints), Some(7));
+  CHECK_EQ(navp::unwrap_or(ints, 0), std::vector<int>{4, 0, -2, 7, 0});
+
+  auto strs = navp::map(ints, [](int x) { return std::to_string(x); });
+  CHECK_EQ(strs[0], Some(std::string("4")));
+  CHECK_EQ(strs[1], None);
+  CHECK_EQ(strs.value_unchecked(1), "");
+  CHECK_EQ(strs.count_some(), 3);
+
+  // f only sees the Some elements
+  int a = 1;
+  int b = 2;
+  OptionVector<int*> ptrs{Some(&a), None, Some(&b)};
+  auto derefs = navp::map(ptrs, [](int* p) { return *p * 10; });
+  CHECK_EQ(derefs[0], Some(10));
+  CHECK_EQ(derefs[1], None);
+  CHECK_EQ(derefs[2], Some(20));
+  OptionVector<int> dense(130);
+  for (std::size_t i = 0; i < dense.size(); ++i) {
+    if (i != 129) {
+      dense.set(i, static_cast<int>(i));
+    }
+  }
+  std::size_t calls = 0;
+  auto doubled = navp::map(dense, [&](int x) {
+    ++calls;
+    return x * 2;
+  });
+  CHECK_EQ(calls, 129);
+  CHECK_EQ(doubled[128], Some(256));
+  CHECK_EQ(doubled[129], None);
+
+  // infinities are values like any other, on the portable path (float) and the double kernels
+  const float inf = std::numeric_limits<float>::infinity();
+  CHECK_EQ(navp::min_some(OptionVector<float>{Some(inf), None}), Some(inf));
+  CHECK_EQ(navp::max_some(OptionVector<float>{Some(-inf)}), Some(-inf));
+  CHECK_EQ(navp::min_some(OptionVector<double>{Some(HUGE_VAL)}), Some(HUGE_VAL));
+  CHECK_EQ(navp::max_some(OptionVector<double>{None, Some(-HUGE_VAL)}), Some(-HUGE_VAL));
+
+  // the mean of ints does not overflow
+  OptionVector<int> big{Some(2000000000), Some(2000000000), None, Some(2000000000)};
+  CHECK_EQ(navp::mean_some(big), Some(2e9));
+  // nor does the mean of 8-byte integers, which are not rounded to double before summing
+  const std::int64_t max64 = std::numeric_limits<std::int64_t>::max();
+  CHECK_EQ(navp::mean_some(OptionVector<std::int64_t>{Some(max64), Some(max64)}), Some(static_cast<double>(max64)));
+  const std::int64_t p53 = std::int64_t{1} << 53;
+  CHECK_EQ(navp::mean_some(OptionVector<std::int64_t>{Some(p53), Some(std::int64_t{1}), Some(std::int64_t{1})}),
+           Some(static_cast<double>(p53 + 2) / 3));
+  CHECK_EQ(navp::mean_some(OptionVector<std::uint64_t>{Some(~std::uint64_t{0}), Some(~std::uint64_t{0})}),
+           Some(static_cast<double>(~std::uint64_t{0})));
+
+  OptionVector<double> nones(10);
+  CHECK_EQ(navp::sum_some(nones), 0.0);
+  CHECK_EQ(navp::mean_some(nones), None);
+  CHECK_EQ(navp::min_some(nones), None);
+  CHECK_EQ(navp::max_some(nones), None);
+}
+
+TEST_CASE("Bulk Kernels") {
+  using namespace navp::details;
+  for (std::size_t n : {0, 1, 3, 4, 7, 8, 63, 64, 65, 130, 1000}) {
+    for (double density : {0.0, 0.3, 1.0}) {
+      auto vec = random_vector(n, density, static_cast<unsigned>(n));
+      const double* v = vec.values();
+      const auto* bits = vec.bitmap();
+      const double sum = sum_some_scalar(v, bits, n);
+      const double lo = extreme_some_scalar(v, bits, n, HUGE_VAL, std::less<double>{});
+      const double hi = extreme_some_scalar(v, bits, n, -HUGE_VAL, std::greater<double>{});
+      std::vector<double> filled(n);
+      unwrap_or_scalar(v, bits, n, 0.5, filled.data());
+
+      CHECK_EQ(navp::sum_some(vec), sum);
+      CHECK_EQ(navp::unwrap_or(vec, 0.5), filled);
+      if (vec.count_some() > 0) {
+        CHECK_EQ(navp::min_some(vec), Some(lo));
+        CHECK_EQ(navp::max_some(vec), Some(hi));
+      }
+
+#ifdef NAVP_X86_SIMD
+      std::vector<double> out(n);
+      if (__builtin_cpu_supports("avx2")) {
+        CHECK_EQ(sum_some_avx2(v, bits, n), sum);
+        CHECK_EQ(extreme_some_avx2<false>(v, bits, n), lo);
+        CHECK_EQ(extreme_some_avx2<true>(v, bits, n), hi);
+        unwrap_or_avx2(v, bits, n, 0.5, out.data());
+        CHECK_EQ(out, filled);
+      }
+      if (__builtin_cpu_supports("avx512f")) {
+        CHECK_EQ(sum_some_avx512(v, bits, n), sum);
+        CHECK_EQ(extreme_some_avx512<false>(v, bits, n), lo);
+        CHECK_EQ(extreme_some_avx512<true>(v, bits, n), hi);
+        unwrap_or_avx512(v, bits, n, 0.5, out.data());
+        CHECK_EQ(out, filled);
+      }
+#endif
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+// built with -fno-exceptions by xmake, where NAVP_PANIC_ABORT is the default policy
+#if !defined(__cpp_exceptions)
+#define DOCTEST_CONFIG_NO_EXCEPTIONS_BUT_WITH_ALL_ASSERTS
+#endif
+#define NAVP_PANIC_POLICY NAVP_PANIC_ABORT
+
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../src/option.hpp"
+#include "../src/result.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+struct death {
+  int signal = 0;
+  std::string stderr_text;
+};
+
+// run f in a child process with its stderr captured, and return the signal that ended it (0 when it exited normally)
+template <typename F>
+static death run_child(F&& f) {
+  int fds[2];
+  REQUIRE(pipe(fds) == 0);
+  std::fflush(nullptr);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    // doctest reports crashes from its own signal handler, the child dies quietly
+    std::signal(SIGABRT, SIG_DFL);
+    close(fds[0]);
+    dup2(fds[1], STDERR_FILENO);
+    f();
+    _exit(0);
+  }
+  close(fds[1]);
+  death d;
+  char buf[512];
+  for (ssize_t n; (n = read(fds[0], buf, sizeof(buf))) > 0;) {
+    d.stderr_text.append(buf, static_cast<std::size_t>(n));
+  }
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  d.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+  return d;
+}
+
+TEST_CASE("Panic Abort") {
+  auto none = run_child([] { (void)Option<int>().expect("missing config"); });
+  CHECK(none.signal == SIGABRT);
+  CHECK(none.stderr_text.find("navp panic: missing config at ") != std::string::npos);
+  CHECK(none.stderr_text.find("test_panic_abort.cpp") != std::string::npos);
+
+  // a runtime message is printed, not just literals
+  auto err = run_child([] {
+    std::string msg = "request " + std::to_string(42);
+    (void)Result<int, int>(Err(1)).expect(msg.c_str());
+  });
+  CHECK(err.signal == SIGABRT);
+  CHECK(err.stderr_text.find("navp panic: request 42 at ") != std::string::npos);
+
+  auto ok = run_child([] { (void)Option<int>(Some(1)).expect("unused"); });
+  CHECK(ok.signal == 0);
+  CHECK(ok.stderr_text.empty());
+}
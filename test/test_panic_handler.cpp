@@ -0,0 +1,89 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define NAVP_PANIC_POLICY NAVP_PANIC_HANDLER
+
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../src/option.hpp"
+#include "../src/result.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+// what the last handler call received
+static std::string g_msg;
+static unsigned g_line = 0;
+
+// a handler that does not return: it leaves the failing call by throwing
+struct handled {};
+
+static void throwing_handler(const char* msg, const std::source_location& loc) {
+  g_msg = msg;
+  g_line = loc.line();
+  throw handled{};
+}
+
+static void returning_handler(const char*, const std::source_location&) {}
+
+// run f in a child process and return the signal that ended it, 0 when it exited normally
+template <typename F>
+static int death_signal(F&& f) {
+  std::fflush(nullptr);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    // doctest reports crashes from its own signal handler, the child dies quietly
+    std::signal(SIGABRT, SIG_DFL);
+    f();
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+}
+
+TEST_CASE("Panic Handler") {
+  REQUIRE(navp::set_panic_handler(throwing_handler) == nullptr);
+
+  Option<int> none = None;
+  const auto line = std::source_location::current().line();
+  CHECK_THROWS_AS(none.unwrap(), handled);
+  CHECK(g_line == line + 1);
+
+  CHECK_THROWS_AS(none.expect("no value"), handled);
+  CHECK(g_msg == "no value");
+
+  Result<int, int> err = Err(1);
+  CHECK_THROWS_AS(err.expect("not ok"), handled);
+  CHECK(g_msg == "not ok");
+  Result<int, int> ok = Ok(2);
+  CHECK_THROWS_AS(ok.unwrap_err(), handled);
+
+  // the success paths do not reach the handler
+  g_msg.clear();
+  CHECK(Option<int>(Some(3)).unwrap() == 3);
+  CHECK(ok.expect("ok") == 2);
+  CHECK(g_msg.empty());
+
+  CHECK(navp::set_panic_handler(nullptr) == throwing_handler);
+}
+
+TEST_CASE("Panic Handler Abort") {
+  // a handler that returns, or no handler at all, ends in std::abort()
+  CHECK(death_signal([] {
+          navp::set_panic_handler(returning_handler);
+          (void)Option<int>().unwrap();
+        }) == SIGABRT);
+  CHECK(death_signal([] {
+          navp::set_panic_handler(nullptr);
+          (void)Result<int, int>(Err(1)).unwrap();
+        }) == SIGABRT);
+  CHECK(death_signal([] { (void)Option<int>(Some(1)).unwrap(); }) == 0);
+}
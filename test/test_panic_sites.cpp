@@ -0,0 +1,47 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define NAVP_EAGER_TRACE
+#define NAVP_PANIC_SITE_CAPACITY 4
+
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+
+#include "../src/option.hpp"
+#include "doctest.h"
+
+using navp::None;
+using navp::Option;
+
+static std::size_t tracked_sites() {
+  std::size_t sites = 0;
+  navp::for_each_panic_site([&](const char*, std::uint32_t, std::uint64_t) { ++sites; });
+  return sites;
+}
+
+TEST_CASE("Full Site Table") {
+  using navp::details::should_print_trace;
+  static_assert(navp::details::panic_site_table::capacity == 4);
+
+  // the first failure at each of the 4 tracked sites prints the trace
+  const auto first = std::source_location::current();
+  CHECK(should_print_trace("a", first));
+  CHECK(should_print_trace("b", std::source_location::current()));
+  CHECK(should_print_trace("c", std::source_location::current()));
+  CHECK(should_print_trace("d", std::source_location::current()));
+  CHECK(tracked_sites() == 4);
+  CHECK(!should_print_trace("a", first));
+
+  // further sites never print it, they are only counted together
+  const auto untracked = std::source_location::current();
+  for (int i = 0; i < 100; ++i) {
+    CHECK(!should_print_trace("e", untracked));
+  }
+  CHECK(!should_print_trace("f", std::source_location::current()));
+  CHECK(navp::untracked_panic_failures() == 101);
+  CHECK(tracked_sites() == 4);
+
+  // through expect()
+  Option<int> none = None;
+  CHECK_THROWS_AS(none.expect("untracked"), navp::option_error);
+  CHECK(navp::untracked_panic_failures() == 102);
+}
@@ -0,0 +1,142 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/parallel.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+using result_t = Result<long, std::string>;
+
+static std::vector<int> iota_vector(int n) {
+  std::vector<int> v(static_cast<std::size_t>(n));
+  std::iota(v.begin(), v.end(), 0);
+  return v;
+}
+
+TEST_CASE("Par Map") {
+  auto input = iota_vector(100000);
+  auto squares = navp::par_map(input, [](int x) -> result_t { return Ok(long{x} * x); });
+  REQUIRE(squares.is_ok());
+  const auto& out = squares.unwrap();
+  REQUIRE_EQ(out.size(), input.size());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    REQUIRE_EQ(out[i], long(i) * long(i));
+  }
+
+  auto empty = navp::par_map(std::vector<int>{}, [](int x) -> result_t { return Ok(long{x}); });
+  CHECK(empty.unwrap().empty());
+
+  // a single thread runs on the caller
+  auto single = navp::par_map(input, [](int x) -> result_t { return Ok(long{x}); }, {.threads = 1});
+  CHECK_EQ(single.unwrap().back(), 99999);
+}
+
+TEST_CASE("Earliest Error") {
+  auto input = iota_vector(100000);
+  // several failures, the earliest index must win whatever the scheduling
+  for (int round = 0; round < 20; ++round) {
+    auto r = navp::par_map(
+        input,
+        [](int x) -> result_t {
+          if (x == 77777 || x == 4242 || x == 50000) {
+            return Err(std::to_string(x));
+          }
+          return Ok(long{x});
+        },
+        {.threads = 8, .chunk = 64});
+    REQUIRE(r.is_err());
+    REQUIRE_EQ(r.unwrap_err(), "4242");
+  }
+}
+
+TEST_CASE("Cancellation") {
+  auto input = iota_vector(1000000);
+  std::atomic<std::size_t> calls{0};
+  auto r = navp::par_map(
+      input,
+      [&](int x) -> result_t {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        if (x == 10) {
+          return Err(std::string("early"));
+        }
+        return Ok(long{x});
+      },
+      {.threads = 4, .chunk = 1000});
+  CHECK_EQ(r.unwrap_err(), "early");
+  // chunks after the failure are not started
+  CHECK_LT(calls.load(), input.size() / 2);
+}
+
+TEST_CASE("Par Map Option") {
+  auto input = iota_vector(10000);
+  auto halves = navp::par_map(input, [](int x) -> Option<int> { return Some(x / 2); });
+  CHECK_EQ(halves.unwrap()[9999], 4999);
+
+  auto none = navp::par_map(input, [](int x) -> Option<int> {
+    if (x == 5000) {
+      return None;
+    }
+    return Some(x);
+  });
+  CHECK_EQ(none, None);
+}
+
+TEST_CASE("Exception") {
+  auto input = iota_vector(10000);
+  CHECK_THROWS_AS(navp::par_map(input,
+                                [](int x) -> result_t {
+                                  if (x == 1234) {
+                                    throw std::logic_error("boom");
+                                  }
+                                  return Ok(long{x});
+                                }),
+                  std::logic_error);
+}
+
+TEST_CASE("Earliest Exception") {
+  auto input = iota_vector(100000);
+  // several elements throw, the one with the smallest index is rethrown whatever the scheduling
+  for (int round = 0; round < 20; ++round) {
+    try {
+      (void)navp::par_map(
+          input,
+          [](int x) -> result_t {
+            if (x == 77777 || x == 4242 || x == 50000) {
+              throw std::runtime_error(std::to_string(x));
+            }
+            return Ok(long{x});
+          },
+          {.threads = 8, .chunk = 64});
+      FAIL("par_map did not throw");
+    } catch (const std::runtime_error& e) {
+      REQUIRE_EQ(std::string(e.what()), "4242");
+    }
+  }
+
+  // an error before the throwing element wins, as in a sequential loop
+  for (int round = 0; round < 20; ++round) {
+    auto r = navp::par_map(
+        input,
+        [](int x) -> result_t {
+          if (x == 50000) {
+            throw std::logic_error("late");
+          }
+          if (x == 4242) {
+            return Err(std::string("early"));
+          }
+          return Ok(long{x});
+        },
+        {.threads = 8, .chunk = 64});
+    REQUIRE_EQ(r.unwrap_err(), "early");
+  }
+}
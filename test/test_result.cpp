@@ -1,5 +1,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define NAVP_LAZY_TRACE
 #include <expected>
+#include <memory>
 
 #include "../src/option.hpp"
 #include "../src/result.hpp"
@@ -31,9 +33,10 @@ TEST_CASE("Triviality") {
 
   static_assert(!std::is_trivially_constructible_v<result_t>);
   static_assert(std::is_trivially_copy_constructible<result_t>::value);
-  static_assert(!std::is_trivially_copy_assignable<result_t>::value);
+  static_assert(std::is_trivially_copy_assignable<result_t>::value);
   static_assert(std::is_trivially_move_constructible<result_t>::value);
-  static_assert(!std::is_trivially_move_assignable<result_t>::value);
+  static_assert(std::is_trivially_move_assignable<result_t>::value);
+  static_assert(std::is_trivially_copyable_v<result_t>);
   static_assert(std::is_trivially_destructible<result_t>::value);
 
   static_assert(!std::is_trivially_constructible_v<expected_t>);
@@ -65,9 +68,9 @@ TEST_CASE("Triviality") {
 
     static_assert(!std::is_trivially_constructible_v<Result<T, T>>);
     static_assert(std::is_trivially_copy_constructible<Result<T, T>>::value);
-    static_assert(!std::is_trivially_copy_assignable<Result<T, T>>::value);
+    static_assert(std::is_trivially_copy_assignable<Result<T, T>>::value);
     static_assert(std::is_trivially_move_constructible<Result<T, T>>::value);
-    static_assert(!std::is_trivially_move_assignable<Result<T, T>>::value);
+    static_assert(std::is_trivially_move_assignable<Result<T, T>>::value);
     static_assert(std::is_trivially_destructible<Result<T, T>>::value);
   }
 
@@ -98,6 +101,92 @@ TEST_CASE("Triviality") {
     static_assert(!std::is_trivially_move_assignable<Result<T, T>>::value);
     static_assert(!std::is_trivially_destructible<Result<T, T>>::value);
   }
+
+  {
+    typedef Result<std::unique_ptr<int>, int> T;
+    static_assert(!std::is_copy_constructible_v<T>);
+    static_assert(!std::is_copy_assignable_v<T>);
+    static_assert(std::is_nothrow_move_constructible_v<T>);
+    static_assert(std::is_nothrow_move_assignable_v<T>);
+  }
+}
+
+TEST_CASE("Size") {
+  static_assert(sizeof(Result<int, int>) == sizeof(std::expected<int, int>));
+  static_assert(sizeof(Result<double, int>) == sizeof(std::expected<double, int>));
+  static_assert(sizeof(Result<std::string, int>) == sizeof(std::expected<std::string, int>));
+  static_assert(sizeof(Result<char, char>) == 2);
+}
+
+TEST_CASE("Storage") {
+  static int alive = 0;
+  struct Counted {
+    std::string str;
+    Counted(const char* s) : str(s) { ++alive; }
+    Counted(const Counted& other) : str(other.str) { ++alive; }
+    Counted(Counted&& other) noexcept : str(std::move(other.str)) { ++alive; }
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&&) = default;
+    ~Counted() { --alive; }
+  };
+  {
+    typedef Result<Counted, Counted> T;
+    T t0 = Ok("ok");
+    T t1 = Err("err");
+    CHECK(alive == 2);
+    t0 = t1;
+    CHECK(t0.is_err());
+    CHECK(t0.unwrap_err().str == "err");
+    CHECK(alive == 2);
+    t1 = T(Ok("ok again"));
+    CHECK(t1.is_ok());
+    CHECK(t1.unwrap().str == "ok again");
+    CHECK(alive == 2);
+    T t2 = std::move(t1);
+    CHECK(t2.unwrap().str == "ok again");
+    CHECK(alive == 3);
+  }
+  CHECK(alive == 0);
+}
+
+TEST_CASE("Throwing Assignment") {
+  static int alive = 0;
+  struct Fragile {
+    int v;
+    bool fail = false;
+    explicit Fragile(int x, bool f = false) : v(x), fail(f) { ++alive; }
+    Fragile(const Fragile& other) : v(other.v) {
+      if (other.fail) {
+        throw std::runtime_error("copy");
+      }
+      ++alive;
+    }
+    Fragile(Fragile&& other) noexcept : v(other.v) { ++alive; }
+    Fragile& operator=(const Fragile& other) {
+      if (other.fail) {
+        throw std::runtime_error("copy");
+      }
+      v = other.v;
+      return *this;
+    }
+    Fragile& operator=(Fragile&&) noexcept = default;
+    ~Fragile() { --alive; }
+  };
+  {
+    const Fragile bad(2, true);
+    Result<Fragile, int> r = Fragile(1);
+    CHECK_THROWS(r = bad);
+    CHECK(r.unwrap().v == 1);
+    r = navp::Err(7);
+    CHECK_THROWS(r = bad);
+    CHECK(r.unwrap_err() == 7);
+
+    Result<int, Fragile> e = Fragile(3);
+    CHECK_THROWS(e = bad);
+    CHECK(e.unwrap_err().v == 3);
+    CHECK(alive == 2);
+  }
+  CHECK(alive == 0);
 }
 
 TEST_CASE("Constructor,Assignment for Ok and Err") {
@@ -234,4 +323,111 @@ TEST_CASE("Extension") {
   auto x3 = u13.map_or_else<bool>([](const std::string& str) { return str == "Error"; },
                                   [](const double& val) { return val >= 0.0; });
   CHECK(x3 == true);
-}
\ No newline at end of file
+}
+TEST_CASE("Lazy Trace") {
+  typedef Result<double, std::string> U;
+  U u1 = "Error";
+  try {
+    u1.unwrap();
+    FAIL("unwrap should throw");
+  } catch (const navp::result_error& e) {
+    CHECK(std::string(e.what()) == "unwrap a result with err value!");
+    CHECK(!e.raw_trace().empty());
+    const auto& trace = e.trace();
+    CHECK(&trace == &e.trace());
+  }
+}
+
+TEST_CASE("Source Location") {
+  typedef Result<double, std::string> U;
+  U u1 = "Error";
+  const auto line = std::source_location::current().line() + 2;
+  try {
+    u1.expect("expect a result with err value");
+    FAIL("expect should throw");
+  } catch (const navp::result_error& e) {
+    CHECK(std::string(e.what()) == "expect a result with err value");
+    CHECK(e.location().line() == line);
+    CHECK(std::string_view(e.location().file_name()).ends_with("test_result.cpp"));
+  }
+
+  U u2 = 1.0;
+  try {
+    std::move(u2).unwrap_err();
+    FAIL("unwrap_err should throw");
+  } catch (const navp::result_error& e) {
+    CHECK(std::string(e.what()) == "unwrap_err a result with ok value!");
+    CHECK(std::string_view(e.location().function_name()).find("DOCTEST") != std::string_view::npos);
+  }
+}
+
+TEST_CASE("Static Message") {
+  static constexpr char literal[] = "a static message";
+  Result<int, int> r = Err(1);
+  try {
+    r.expect(literal);
+    FAIL("expect should throw");
+  } catch (const navp::result_error& e) {
+    // the literal is not copied
+    CHECK(e.what() == literal);
+  }
+
+  // any other string is copied, it may die before the error
+  const std::string key = "k";
+  try {
+    std::move(r).expect(("missing key " + key).c_str());
+    FAIL("expect should throw");
+  } catch (const std::runtime_error& e) {
+    CHECK(std::string(e.what()) == "missing key k");
+  }
+
+  Result<int, int> ok = Ok(1);
+  try {
+    ok.expect_err("expected an err");
+    FAIL("expect_err should throw");
+  } catch (const navp::result_error& e) {
+    CHECK(std::string(e.what()) == "expected an err");
+  }
+}
+
+TEST_CASE("Void") {
+  typedef Result<void, int> Status;
+  static_assert(sizeof(Status) == sizeof(std::expected<void, int>));
+  static_assert(sizeof(Status) == 2 * sizeof(int));
+  static_assert(std::is_trivially_copyable_v<Status>);
+  static_assert(std::is_same_v<decltype(std::declval<Status&>().unwrap()), void>);
+
+  auto check = [](int code) -> Status {
+    if (code != 0) {
+      return Err(code);
+    }
+    return Ok();
+  };
+  Status s0 = check(0);
+  CHECK(s0.is_ok());
+  s0.unwrap();
+  s0.expect("status should be ok");
+  CHECK_THROWS(s0.unwrap_err());
+
+  Status s1 = check(42);
+  CHECK(s1.is_err());
+  CHECK(s1.unwrap_err() == 42);
+  CHECK_THROWS(s1.unwrap());
+  CHECK(std::move(s1).err().unwrap() == 42);
+
+  Status s2;
+  CHECK(s2.is_ok());
+  s2 = Err(1);
+  CHECK(s2.is_err());
+  s2 = Ok();
+  CHECK(s2.is_ok());
+
+  typedef Result<double, void> Maybe;
+  static_assert(sizeof(Maybe) == 2 * sizeof(double));
+  Maybe m0 = 1.0;
+  CHECK(m0.unwrap() == 1.0);
+  Maybe m1 = Err();
+  CHECK(m1.is_err());
+  m1.unwrap_err();
+  CHECK(m1.unwrap_or(2.0) == 2.0);
+}
@@ -0,0 +1,116 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <string>
+#include <vector>
+
+#include "../src/result_vector.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::Ok;
+using navp::Result;
+using navp::ResultVector;
+
+using result_t = Result<int, std::string>;
+
+TEST_CASE("Construct") {
+  ResultVector<int, std::string> empty;
+  CHECK(empty.empty());
+  CHECK_EQ(empty.count_err(), 0);
+
+  ResultVector<int, std::string> vec{Ok(1), Err(std::string("bad")), Ok(3)};
+  CHECK_EQ(vec.size(), 3);
+  CHECK_EQ(vec.count_ok(), 2);
+  CHECK_EQ(vec.count_err(), 1);
+  CHECK(vec.is_ok(0));
+  CHECK(vec.is_err(1));
+  CHECK_EQ(vec[0].unwrap(), 1);
+  CHECK_EQ(vec[1].unwrap_err(), "bad");
+  CHECK_EQ(vec.at(2).unwrap(), 3);
+  CHECK_THROWS_AS(vec.at(3), std::out_of_range);
+
+  std::vector<result_t> results;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 10 == 7) {
+      results.emplace_back(Err(std::to_string(i)));
+    } else {
+      results.emplace_back(Ok(i));
+    }
+  }
+  ResultVector<int, std::string> from_range(results);
+  CHECK_EQ(from_range.size(), 100);
+  CHECK_EQ(from_range.count_err(), 10);
+  CHECK_EQ(from_range.err_unchecked(57), "57");
+  CHECK_EQ(from_range.ok_unchecked(58), 58);
+  CHECK_EQ(from_range.oks().count_some(), 90);
+
+  // from the ok values and a sorted error table
+  using vec_t = ResultVector<int, std::string>;
+  using entry = vec_t::error_entry;
+  vec_t from_parts({1, 2, 3, 4}, {entry{1, "one"}, entry{3, "three"}});
+  CHECK_EQ(from_parts.count_ok(), 2);
+  CHECK_EQ(from_parts[3].unwrap_err(), "three");
+  CHECK_EQ(from_parts[2].unwrap(), 3);
+  // out of range, duplicate and unsorted indices are rejected
+  CHECK_THROWS_AS(vec_t({1, 2}, {entry{2, "past the end"}}), navp::result_error);
+  CHECK_THROWS_AS(vec_t({1, 2, 3}, {entry{1, "a"}, entry{1, "b"}}), navp::result_error);
+  CHECK_THROWS_AS(vec_t({1, 2, 3}, {entry{2, "a"}, entry{0, "b"}}), navp::result_error);
+}
+
+TEST_CASE("Views") {
+  ResultVector<int, std::string> vec;
+  vec.push_ok(10);
+  vec.push_err("a");
+  vec.push_ok(20);
+  vec.push_err("b");
+  vec.push_back(result_t(Ok(30)));
+
+  std::vector<int> oks;
+  for (const int& x : vec.ok_values()) {
+    oks.push_back(x);
+  }
+  CHECK_EQ(oks, std::vector<int>{10, 20, 30});
+
+  auto errs = vec.errors();
+  REQUIRE_EQ(errs.size(), 2);
+  CHECK_EQ(errs[0].first, 1);
+  CHECK_EQ(errs[0].second, "a");
+  CHECK_EQ(errs[1].first, 3);
+  CHECK_EQ(errs[1].second, "b");
+
+  vec.pop_back();
+  vec.pop_back();
+  CHECK_EQ(vec.size(), 3);
+  CHECK_EQ(vec.count_err(), 1);
+}
+
+TEST_CASE("Round Trip") {
+  std::vector<result_t> results{Ok(1), Err(std::string("x")), Err(std::string("y")), Ok(4)};
+  ResultVector<int, std::string> vec(results);
+  auto copy = vec.to_results();
+  REQUIRE_EQ(copy.size(), 4);
+  for (std::size_t i = 0; i < copy.size(); ++i) {
+    CHECK_EQ(copy[i].is_ok(), results[i].is_ok());
+  }
+  CHECK_EQ(copy[2].unwrap_err(), "y");
+
+  auto moved = std::move(vec).to_results();
+  CHECK_EQ(moved[1].unwrap_err(), "x");
+  CHECK_EQ(moved[3].unwrap(), 4);
+  CHECK(vec.empty());
+}
+
+TEST_CASE("Size") {
+  // 1% errors with a large error type
+  constexpr std::size_t n = 10000;
+  ResultVector<double, std::string> vec;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i % 100 == 0) {
+      vec.push_err("error");
+    } else {
+      vec.push_ok(1.0);
+    }
+  }
+  const auto columnar = n * sizeof(double) + vec.oks().bitmap_words() * 8 +
+                        vec.count_err() * sizeof(ResultVector<double, std::string>::error_entry);
+  CHECK_LT(columnar * 3, n * sizeof(Result<double, std::string>));
+}
@@ -0,0 +1,346 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/task.hpp"
+#include "doctest.h"
+
+using namespace std::chrono_literals;
+using navp::Err;
+using navp::EventLoop;
+using navp::Ok;
+using navp::Result;
+using navp::Task;
+using navp::ThreadPool;
+
+using read_t = Result<std::string, std::string>;
+
+// Key-value store answering reads from its own thread after a latency, like an I/O completion thread. A read whose
+// task is asked to stop first finishes with Err("cancelled").
+template <typename Scheduler>
+class FakeIo {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  explicit FakeIo(Scheduler& scheduler) : _m_scheduler(scheduler) {}
+
+  void put(std::string key, std::string val) { _m_data[std::move(key)] = std::move(val); }
+
+  int cancelled() const { return _m_cancelled.load(); }
+
+  class read_awaiter {
+   public:
+    read_awaiter(FakeIo& io, std::string key, clock::duration latency)
+        : _m_io(io), _m_key(std::move(key)), _m_deadline(clock::now() + latency) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) {
+      _m_handle = h;
+      auto token = navp::stop_token_of(h);
+      if (token.stop_possible()) {
+        _m_on_stop.emplace(std::move(token), cancel_fn{this});
+      }
+      auto& io = _m_io;
+      {
+        std::lock_guard lock(io._m_mutex);
+        if (_m_cancelled) {
+          return false;
+        }
+        _m_entry = io._m_pending.emplace(_m_deadline, this);
+        _m_armed = true;
+      }
+      io._m_wake.notify_one();
+      return true;
+    }
+
+    read_t await_resume() {
+      _m_on_stop.reset();
+      if (_m_cancelled) {
+        ++_m_io._m_cancelled;
+        return Err(std::string("cancelled"));
+      }
+      if (auto it = _m_io._m_data.find(_m_key); it != _m_io._m_data.end()) {
+        return Ok(it->second);
+      }
+      return Err("missing: " + _m_key);
+    }
+
+   private:
+    friend FakeIo;
+
+    struct cancel_fn {
+      read_awaiter* self;
+      void operator()() const {
+        {
+          std::lock_guard lock(self->_m_io._m_mutex);
+          self->_m_cancelled = true;
+          if (!self->_m_armed) {
+            return;
+          }
+          self->_m_io._m_pending.erase(self->_m_entry);
+          self->_m_armed = false;
+        }
+        self->_m_io._m_scheduler.post(self->_m_handle);
+      }
+    };
+
+    FakeIo& _m_io;
+    std::string _m_key;
+    clock::time_point _m_deadline;
+    std::coroutine_handle<> _m_handle;
+    typename std::multimap<clock::time_point, read_awaiter*>::iterator _m_entry;
+    bool _m_armed = false;
+    bool _m_cancelled = false;
+    std::optional<std::stop_callback<cancel_fn>> _m_on_stop;
+  };
+
+  read_awaiter read(std::string key, clock::duration latency) { return read_awaiter(*this, std::move(key), latency); }
+
+ private:
+  void _m_complete(std::stop_token stop) {
+    std::unique_lock lock(_m_mutex);
+    while (!stop.stop_requested()) {
+      if (_m_pending.empty()) {
+        _m_wake.wait(lock, stop, [this] { return !_m_pending.empty(); });
+        continue;
+      }
+      // woken early when a read with an earlier deadline arrives or the first one is cancelled
+      const auto first = _m_pending.begin()->first;
+      if (_m_wake.wait_until(lock, stop, first,
+                             [&] { return _m_pending.empty() || _m_pending.begin()->first < first; })) {
+        continue;
+      }
+      std::vector<std::coroutine_handle<>> due;
+      for (auto now = clock::now(); !_m_pending.empty() && _m_pending.begin()->first <= now;) {
+        _m_pending.begin()->second->_m_armed = false;
+        due.push_back(_m_pending.begin()->second->_m_handle);
+        _m_pending.erase(_m_pending.begin());
+      }
+      lock.unlock();
+      for (auto h : due) {
+        _m_scheduler.post(h);
+      }
+      lock.lock();
+    }
+  }
+
+  Scheduler& _m_scheduler;
+  std::map<std::string, std::string> _m_data;
+  std::mutex _m_mutex;
+  std::condition_variable_any _m_wake;
+  std::multimap<clock::time_point, read_awaiter*> _m_pending;
+  std::atomic<int> _m_cancelled{0};
+  std::jthread _m_thread{[this](std::stop_token stop) { _m_complete(stop); }};
+};
+
+template <typename Scheduler>
+static Task<read_t> fetch(FakeIo<Scheduler>& io, std::string key, std::chrono::milliseconds latency) {
+  auto page = co_await io.read(key, latency);
+  if (page.is_err()) {
+    co_return page;
+  }
+  co_return Ok(key + "=" + page.unwrap());
+}
+
+static Task<Result<int, std::string>> one() { co_return Ok(1); }
+
+static Task<Result<int, std::string>> count_up(int n) {
+  int total = 0;
+  for (int i = 0; i < n; ++i) {
+    // completes synchronously every time, symmetric transfer keeps the stack flat
+    total += (co_await one()).unwrap();
+  }
+  co_return Ok(total);
+}
+
+TEST_CASE("Task") {
+  EventLoop loop;
+  CHECK(loop.run(one()).unwrap() == 1);
+  CHECK(loop.run(count_up(1000000)).unwrap() == 1000000);
+
+  SUBCASE("lazy") {
+    bool started = false;
+    auto make = [&]() -> Task<Result<int, std::string>> {
+      started = true;
+      co_return Ok(2);
+    };
+    auto task = make();
+    CHECK(!started);
+    CHECK(!task.done());
+    CHECK(loop.run(std::move(task)).unwrap() == 2);
+    CHECK(started);
+  }
+
+  SUBCASE("exception") {
+    auto boom = []() -> Task<Result<int, std::string>> {
+      throw std::runtime_error("boom");
+      co_return Ok(0);
+    };
+    auto outer = [&]() -> Task<Result<int, std::string>> { co_return co_await boom(); };
+    CHECK_THROWS_AS(loop.run(outer()), std::runtime_error);
+  }
+
+  SUBCASE("schedule and sleep") {
+    std::vector<int> order;
+    auto worker = [&](int id, std::chrono::milliseconds d) -> Task<Result<int, std::string>> {
+      co_await loop.schedule();
+      bool slept = co_await loop.sleep_for(d);
+      order.push_back(id);
+      co_return Ok(slept ? id : -1);
+    };
+    std::vector<Task<Result<int, std::string>>> tasks;
+    tasks.push_back(worker(1, 30ms));
+    tasks.push_back(worker(2, 10ms));
+    tasks.push_back(worker(3, 20ms));
+    CHECK(loop.run(navp::when_all(std::move(tasks))).unwrap() == std::vector{1, 2, 3});
+    CHECK(order == std::vector{2, 3, 1});
+  }
+}
+
+TEST_CASE("Task When All") {
+  EventLoop loop;
+  FakeIo io(loop);
+  io.put("a", "1");
+  io.put("b", "2");
+  io.put("c", "3");
+
+  SUBCASE("all ok") {
+    std::vector<Task<read_t>> reads;
+    reads.push_back(fetch(io, "a", 20ms));
+    reads.push_back(fetch(io, "b", 1ms));
+    reads.push_back(fetch(io, "c", 10ms));
+    CHECK(loop.run(navp::when_all(std::move(reads))).unwrap() == std::vector<std::string>{"a=1", "b=2", "c=3"});
+  }
+
+  SUBCASE("first error cancels the others") {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Task<read_t>> reads;
+    reads.push_back(fetch(io, "a", 60s));
+    reads.push_back(fetch(io, "missing", 5ms));
+    reads.push_back(fetch(io, "b", 60s));
+    CHECK(loop.run(navp::when_all(std::move(reads))).unwrap_err() == "missing: missing");
+    CHECK(io.cancelled() == 2);
+    CHECK(std::chrono::steady_clock::now() - start < 30s);
+  }
+
+  SUBCASE("cancels sleeps") {
+    auto sleeper = [&]() -> Task<Result<void, std::string>> {
+      if (co_await loop.sleep_for(60s)) {
+        co_return Ok();
+      }
+      auto token = co_await navp::get_stop_token();
+      co_return Err(std::string(token.stop_requested() ? "stopped" : "?"));
+    };
+    auto failing = [&]() -> Task<Result<void, std::string>> {
+      co_await loop.sleep_for(1ms);
+      co_return Err(std::string("failed"));
+    };
+    std::vector<Task<Result<void, std::string>>> tasks;
+    tasks.push_back(sleeper());
+    tasks.push_back(failing());
+    CHECK(loop.run(navp::when_all(std::move(tasks))).unwrap_err() == "failed");
+  }
+
+  SUBCASE("nested") {
+    auto pair = [&](std::string x, std::string y) -> Task<Result<std::vector<std::string>, std::string>> {
+      std::vector<Task<read_t>> reads;
+      reads.push_back(fetch(io, x, 1ms));
+      reads.push_back(fetch(io, y, 60s));
+      co_return co_await navp::when_all(std::move(reads));
+    };
+    auto outer = [&]() -> Task<Result<std::vector<std::vector<std::string>>, std::string>> {
+      std::vector<Task<Result<std::vector<std::string>, std::string>>> pairs;
+      pairs.push_back(pair("a", "b"));
+      pairs.push_back(pair("missing", "c"));
+      co_return co_await navp::when_all(std::move(pairs));
+    };
+    // the error in the second pair stops the slow read of the first one too
+    CHECK(loop.run(outer()).unwrap_err() == "missing: missing");
+    CHECK(io.cancelled() == 2);
+  }
+
+  SUBCASE("empty") { CHECK(loop.run(navp::when_all(std::vector<Task<read_t>>{})).unwrap().empty()); }
+}
+
+TEST_CASE("Task When Any") {
+  EventLoop loop;
+  FakeIo io(loop);
+  io.put("a", "1");
+  io.put("b", "2");
+
+  SUBCASE("first ok wins") {
+    std::vector<Task<read_t>> reads;
+    reads.push_back(fetch(io, "a", 60s));
+    reads.push_back(fetch(io, "missing", 1ms));
+    reads.push_back(fetch(io, "b", 5ms));
+    CHECK(loop.run(navp::when_any(std::move(reads))).unwrap() == "b=2");
+    CHECK(io.cancelled() == 1);
+  }
+
+  SUBCASE("all fail") {
+    std::vector<Task<read_t>> reads;
+    reads.push_back(fetch(io, "x", 10ms));
+    reads.push_back(fetch(io, "y", 1ms));
+    CHECK(loop.run(navp::when_any(std::move(reads))).unwrap_err() == "missing: y");
+    CHECK(io.cancelled() == 0);
+  }
+}
+
+TEST_CASE("Task Thread Pool") {
+  ThreadPool pool(4);
+  CHECK(pool.threads() == 4);
+  FakeIo io(pool);
+  for (int i = 0; i < 100; ++i) {
+    io.put(std::to_string(i), std::to_string(i * i));
+  }
+
+  SUBCASE("when_all") {
+    std::vector<Task<read_t>> reads;
+    for (int i = 0; i < 100; ++i) {
+      reads.push_back(fetch(io, std::to_string(i), std::chrono::milliseconds(i % 7)));
+    }
+    auto pages = pool.run(navp::when_all(std::move(reads))).unwrap();
+    REQUIRE(pages.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+      CHECK(pages[i] == std::to_string(i) + "=" + std::to_string(i * i));
+    }
+  }
+
+  SUBCASE("error cancels") {
+    std::vector<Task<read_t>> reads;
+    for (int i = 0; i < 50; ++i) {
+      reads.push_back(fetch(io, std::to_string(i), 60s));
+    }
+    reads.push_back(fetch(io, "missing", 2ms));
+    CHECK(pool.run(navp::when_all(std::move(reads))).unwrap_err() == "missing: missing");
+    CHECK(io.cancelled() == 50);
+  }
+
+  SUBCASE("when_any and schedule") {
+    std::atomic<int> hops{0};
+    auto hop = [&](int i) -> Task<read_t> {
+      co_await pool.schedule();
+      ++hops;
+      co_return co_await fetch(io, std::to_string(i), std::chrono::milliseconds(i == 3 ? 1 : 60000));
+    };
+    std::vector<Task<read_t>> tasks;
+    for (int i = 0; i < 8; ++i) {
+      tasks.push_back(hop(i));
+    }
+    CHECK(pool.run(navp::when_any(std::move(tasks))).unwrap() == "3=9");
+    CHECK(hops == 8);
+    CHECK(io.cancelled() == 7);
+  }
+}
@@ -0,0 +1,130 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <charconv>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "../src/try.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+using parsed_t = Result<int, std::string>;
+
+static parsed_t parse(std::string_view s) {
+  int v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size()) {
+    return Err("not a number: " + std::string(s));
+  }
+  return Ok(v);
+}
+
+// counts copies of the error on the way up
+struct Tracked {
+  static inline int copies = 0;
+  int code;
+  explicit Tracked(int c) : code(c) {}
+  Tracked(const Tracked& other) : code(other.code) { ++copies; }
+  Tracked(Tracked&&) = default;
+};
+
+static Result<int, Tracked> fail_at(int depth) {
+  if (depth == 0) {
+    return Err(Tracked(7));
+  }
+  return Ok(NAVP_TRY(fail_at(depth - 1)) + 1);
+}
+
+TEST_CASE("Try") {
+  auto sum = [](std::string_view a, std::string_view b) -> parsed_t {
+    int x = NAVP_TRY(parse(a));
+    return Ok(x + NAVP_TRY(parse(b)));
+  };
+  CHECK(sum("1", "2").unwrap() == 3);
+  CHECK(sum("1", "b").unwrap_err() == "not a number: b");
+  CHECK(sum("a", "b").unwrap_err() == "not a number: a");
+
+  SUBCASE("moves the error") {
+    Tracked::copies = 0;
+    auto r = fail_at(5);
+    CHECK(r.unwrap_err().code == 7);
+    CHECK(Tracked::copies == 0);
+  }
+
+  SUBCASE("copies from an lvalue") {
+    const parsed_t bad = parse("x");
+    auto f = [&]() -> Result<int, std::string> { return Ok(NAVP_TRY(bad)); };
+    CHECK(f().unwrap_err() == "not a number: x");
+    CHECK(bad.unwrap_err() == "not a number: x");
+  }
+
+  SUBCASE("move-only value") {
+    auto make = [](bool ok) -> Result<std::unique_ptr<int>, int> {
+      if (!ok) {
+        return Err(1);
+      }
+      return Ok(std::make_unique<int>(4));
+    };
+    auto f = [&](bool ok) -> Result<int, int> {
+      std::unique_ptr<int> p = NAVP_TRY(make(ok));
+      return Ok(*p);
+    };
+    CHECK(f(true).unwrap() == 4);
+    CHECK(f(false).unwrap_err() == 1);
+  }
+}
+
+TEST_CASE("Try Void") {
+  auto check_positive = [](int x) -> Result<void, std::string> {
+    if (x <= 0) {
+      return Err(std::string("not positive"));
+    }
+    return Ok();
+  };
+  auto f = [&](int x) -> Result<int, std::string> {
+    NAVP_TRY(check_positive(x));
+    NAVP_TRY_DISCARD(check_positive(x - 1));
+    return Ok(x);
+  };
+  CHECK(f(2).unwrap() == 2);
+  CHECK(f(1).unwrap_err() == "not positive");
+  CHECK(f(0).unwrap_err() == "not positive");
+}
+
+TEST_CASE("Try Assign") {
+  auto sum = [](std::string_view a, std::string_view b) -> parsed_t {
+    NAVP_TRY_ASSIGN(int x, parse(a));
+    NAVP_TRY_ASSIGN(auto y, parse(b));
+    int z = 0;
+    NAVP_TRY_ASSIGN(z, parse("10"));
+    return Ok(x + y + z);
+  };
+  CHECK(sum("1", "2").unwrap() == 13);
+  CHECK(sum("1", "?").unwrap_err() == "not a number: ?");
+}
+
+TEST_CASE("Try Option") {
+  auto half = [](int x) -> Option<int> {
+    if (x % 2 != 0) {
+      return None;
+    }
+    return Some(x / 2);
+  };
+  auto quarter = [&](int x) -> Option<int> { return half(NAVP_TRY(half(x))); };
+  auto eighth = [&](int x) -> Option<int> {
+    NAVP_TRY_ASSIGN(int q, quarter(x));
+    NAVP_TRY_DISCARD(half(q));
+    return Some(q / 2);
+  };
+  CHECK(quarter(12).unwrap() == 3);
+  CHECK(quarter(6).is_none());
+  CHECK(quarter(3).is_none());
+  CHECK(eighth(16).unwrap() == 2);
+  CHECK(eighth(12).is_none());
+}
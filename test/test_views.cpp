@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <charconv>
+#include <list>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/views.hpp"
+#include "doctest.h"
+
+using navp::Err;
+using navp::None;
+using navp::Ok;
+using navp::Option;
+using navp::Result;
+using navp::Some;
+
+using parsed_t = Result<int, std::string>;
+
+static parsed_t parse(std::string_view s) {
+  int v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size()) {
+    return Err(std::string(s));
+  }
+  return Ok(v);
+}
+
+template <typename R>
+static auto to_vector(R&& range) {
+  std::vector<std::remove_cvref_t<std::ranges::range_reference_t<R>>> out;
+  for (auto&& x : range) {
+    out.push_back(x);
+  }
+  return out;
+}
+
+TEST_CASE("Somes") {
+  std::vector<Option<int>> ops{Some(1), None, Some(3), None, Some(5)};
+  auto somes = ops | navp::views::somes;
+  static_assert(std::ranges::forward_range<decltype(somes)>);
+  static_assert(std::is_same_v<std::ranges::range_reference_t<decltype(somes)>, int&>);
+  CHECK_EQ(to_vector(somes), std::vector<int>{1, 3, 5});
+
+  // references into the underlying range
+  for (int& x : ops | navp::views::somes) {
+    x *= 10;
+  }
+  CHECK_EQ(ops[2], Some(30));
+
+  const auto& cops = ops;
+  static_assert(std::is_same_v<std::ranges::range_reference_t<decltype(cops | navp::views::somes)>, const int&>);
+
+  // composes with std views
+  auto large = ops | navp::views::somes | std::views::filter([](int x) { return x > 20; });
+  CHECK_EQ(to_vector(large), std::vector<int>{30, 50});
+  CHECK(std::ranges::empty(std::vector<Option<int>>(3) | navp::views::somes));
+}
+
+TEST_CASE("Oks Errs") {
+  std::list<std::string_view> lines{"1", "x", "22", "", "333"};
+  int calls = 0;
+  auto parsed = lines | std::views::transform([&](std::string_view s) {
+                  ++calls;
+                  return parse(s);
+                });
+
+  auto oks = parsed | navp::views::oks;
+  static_assert(std::ranges::input_range<decltype(oks)>);
+  CHECK_EQ(to_vector(oks), std::vector<int>{1, 22, 333});
+  // every element is evaluated once
+  CHECK_EQ(calls, 5);
+
+  CHECK_EQ(to_vector(parsed | navp::views::errs), std::vector<std::string>{"x", ""});
+
+  auto pipeline = std::views::transform(parse) | navp::views::oks;
+  CHECK_EQ(to_vector(lines | pipeline), std::vector<int>{1, 22, 333});
+}
+
+TEST_CASE("And Then") {
+  auto half = [](int x) -> parsed_t {
+    if (x % 2 != 0) {
+      return Err("odd " + std::to_string(x));
+    }
+    return Ok(x / 2);
+  };
+
+  std::vector<parsed_t> all_ok{Ok(2), Ok(4), Ok(8)};
+  auto halves = to_vector(all_ok | navp::views::and_then(half));
+  REQUIRE_EQ(halves.size(), 3);
+  CHECK_EQ(halves[2].unwrap(), 4);
+
+  // f's Err is yielded and ends the range
+  std::vector<parsed_t> odd{Ok(2), Ok(3), Ok(4)};
+  auto stopped = to_vector(navp::views::and_then(odd, half));
+  REQUIRE_EQ(stopped.size(), 2);
+  CHECK_EQ(stopped[0].unwrap(), 1);
+  CHECK_EQ(stopped[1].unwrap_err(), "odd 3");
+
+  // an Err element is passed through and ends the range, later elements are not evaluated
+  std::vector<std::string_view> lines{"4", "y", "6"};
+  int calls = 0;
+  auto results = lines | std::views::transform([&](std::string_view s) {
+                   ++calls;
+                   return parse(s);
+                 }) |
+                 navp::views::and_then(half);
+  auto out = to_vector(results);
+  REQUIRE_EQ(out.size(), 2);
+  CHECK_EQ(out[0].unwrap(), 2);
+  CHECK_EQ(out[1].unwrap_err(), "y");
+  CHECK_EQ(calls, 2);
+}
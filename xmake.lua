@@ -24,3 +24,193 @@ target("test_result")
     add_packages("cpptrace")
     add_files("test/test_result.cpp")
 target_end()
+
+target("test_option_vector")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_option_vector.cpp")
+target_end()
+
+target("test_result_vector")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_result_vector.cpp")
+target_end()
+
+target("test_collect")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_collect.cpp")
+target_end()
+
+target("test_views")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_views.cpp")
+target_end()
+
+target("test_parallel")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_parallel.cpp")
+target_end()
+
+target("test_executor")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_executor.cpp")
+target_end()
+
+target("bench_executor")
+    set_kind("binary")
+    set_languages("c++23")
+    set_optimize("fastest")
+    add_includedirs("src")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("bench/bench_executor.cpp")
+target_end()
+
+target("test_coroutine")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_coroutine.cpp")
+target_end()
+
+target("test_try")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_try.cpp")
+target_end()
+
+target("test_task")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_task.cpp")
+target_end()
+
+target("test_error_code")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_error_code.cpp")
+target_end()
+
+target("test_boxed")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_boxed.cpp")
+target_end()
+
+target("test_context")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread")
+    add_files("test/test_context.cpp")
+target_end()
+
+target("test_atomic_option")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_syslinks("pthread", "atomic")
+    add_files("test/test_atomic_option.cpp")
+target_end()
+
+target("test_panic_handler")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_panic_handler.cpp")
+target_end()
+
+target("test_panic_abort")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_cxflags("-fno-exceptions")
+    add_files("test/test_panic_abort.cpp")
+target_end()
+
+target("test_panic_sites")
+    set_kind("binary")
+    set_languages("c++23")
+    add_includedirs("src")
+    add_includedirs("test")
+    add_packages("cpptrace")
+    add_files("test/test_panic_sites.cpp")
+target_end()
+
+target("bench_coroutine")
+    set_kind("binary")
+    set_languages("c++23")
+    set_optimize("fastest")
+    add_includedirs("src")
+    add_packages("cpptrace")
+    add_files("bench/bench_coroutine.cpp")
+target_end()
+
+target("bench_boxed")
+    set_kind("binary")
+    set_languages("c++23")
+    set_optimize("fastest")
+    add_includedirs("src")
+    add_packages("cpptrace")
+    add_files("bench/bench_boxed.cpp")
+target_end()
+
+target("bench_atomic_option")
+    set_kind("binary")
+    set_languages("c++23")
+    set_optimize("fastest")
+    add_includedirs("src")
+    add_packages("cpptrace")
+    add_syslinks("pthread", "atomic")
+    add_files("bench/bench_atomic_option.cpp")
+target_end()